@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+    Host-automatable analyzer settings and their immutable snapshots.
+  ==============================================================================
+*/
+
+#include "AnalyzerSettings.h"
+#include "SpectrumSmoother.h"
+#include <algorithm>
+
+//==============================================================================
+const std::array<const char*, 14> AnalyzerSettings::parameterIDs{
+    fftSizeID, windowID, channelModeID, averagingID, smoothingID, noiseCalibrationID,
+    targetCurveID, displayFloorID, displayCeilingID, loudnessTargetID, loudnessToleranceID,
+    averagingWeightID, rmsLengthID, peakDecayID
+};
+
+juce::AudioProcessorValueTreeState::ParameterLayout AnalyzerSettings::createParameterLayout()
+{
+    using namespace juce;
+    const AnalyzerSettings defaults;
+
+    // Choice indices are the enum values (FFT size: order - minFFTOrder)
+    StringArray fftSizes, smoothings, genres;
+
+    for (int order = minFFTOrder; order <= maxFFTOrder; ++order)
+        fftSizes.add(String(1 << order));
+
+    for (const int fraction : SpectrumSmoother::fractions)
+        smoothings.add(fraction == 0 ? String("Off") : "1/" + String(fraction) + " oct");
+
+    for (int genre = 0; genre < SpectrumTargets::numGenres; ++genre)
+        genres.add(SpectrumTargets::getName(static_cast<SpectrumTargets::Genre>(genre)));
+
+    auto decibels = [](const String& unit)
+    {
+        return AudioParameterFloatAttributes().withLabel(unit).withStringFromValueFunction(
+            [](float value, int) { return String(value, 1); });
+    };
+
+    AudioProcessorValueTreeState::ParameterLayout layout;
+    layout.add(std::make_unique<AudioParameterChoice>(ParameterID{ fftSizeID, 1 }, "FFT Size", fftSizes,
+                                                      defaults.fftOrder - minFFTOrder),
+               std::make_unique<AudioParameterChoice>(ParameterID{ windowID, 1 }, "Window",
+                                                      StringArray{ "Hann", "Blackman-Harris", "Flat-top", "Kaiser" }, 0),
+               std::make_unique<AudioParameterChoice>(ParameterID{ channelModeID, 1 }, "Channels",
+                                                      StringArray{ "L / R", "M / S" }, 0),
+               std::make_unique<AudioParameterChoice>(ParameterID{ averagingID, 1 }, "Averaging",
+                                                      StringArray{ "Exponential", "RMS", "Infinite" }, 0),
+               std::make_unique<AudioParameterChoice>(ParameterID{ smoothingID, 1 }, "Smoothing", smoothings, 0),
+               std::make_unique<AudioParameterBool>(ParameterID{ noiseCalibrationID, 1 }, "Noise Calibration",
+                                                    defaults.noiseCalibration),
+               std::make_unique<AudioParameterChoice>(ParameterID{ targetCurveID, 1 }, "Target Curve", genres, 0),
+               std::make_unique<AudioParameterFloat>(ParameterID{ displayFloorID, 1 }, "Display Floor",
+                                                     NormalisableRange<float>(-120.0f, -40.0f, 1.0f),
+                                                     defaults.displayFloor, decibels("dB")),
+               std::make_unique<AudioParameterFloat>(ParameterID{ displayCeilingID, 1 }, "Display Ceiling",
+                                                     NormalisableRange<float>(-30.0f, 12.0f, 1.0f),
+                                                     defaults.displayCeiling, decibels("dB")),
+               std::make_unique<AudioParameterFloat>(ParameterID{ loudnessTargetID, 1 }, "Loudness Target",
+                                                     NormalisableRange<float>(-36.0f, -6.0f, 0.5f),
+                                                     defaults.loudnessTarget, decibels("LUFS")),
+               std::make_unique<AudioParameterFloat>(ParameterID{ loudnessToleranceID, 1 }, "Loudness Tolerance",
+                                                     NormalisableRange<float>(0.5f, 6.0f, 0.5f),
+                                                     defaults.loudnessTolerance, decibels("LU")),
+               std::make_unique<AudioParameterFloat>(ParameterID{ averagingWeightID, 1 }, "Averaging Weight",
+                                                     NormalisableRange<float>(0.01f, 1.0f, 0.01f),
+                                                     defaults.averagingWeight,
+                                                     AudioParameterFloatAttributes().withStringFromValueFunction(
+                                                         [](float value, int) { return String(value, 2); })),
+               std::make_unique<AudioParameterInt>(ParameterID{ rmsLengthID, 1 }, "RMS Length",
+                                                   1, SpectrumAverager::maxRMSFrames, defaults.rmsLength,
+                                                   AudioParameterIntAttributes().withLabel("frames")),
+               std::make_unique<AudioParameterFloat>(ParameterID{ peakDecayID, 1 }, "Peak Decay",
+                                                     NormalisableRange<float>(1.0f, 60.0f, 0.5f),
+                                                     defaults.peakDecay, decibels("dB/s")));
+    return layout;
+}
+
+AnalyzerSettings AnalyzerSettings::fromParameters(const juce::AudioProcessorValueTreeState& parameters)
+{
+    auto value = [&parameters](const char* id) { return parameters.getRawParameterValue(id)->load(); };
+    auto index = [&value](const char* id) { return juce::roundToInt(value(id)); };
+
+    AnalyzerSettings settings;
+    settings.fftOrder = juce::jlimit(minFFTOrder, maxFFTOrder, minFFTOrder + index(fftSizeID));
+    settings.windowType = static_cast<WindowType>(index(windowID));
+    settings.channelMode = static_cast<ChannelMode>(index(channelModeID));
+    settings.averagingMode = static_cast<SpectrumAverager::Mode>(index(averagingID));
+    settings.averagingWeight = juce::jlimit(0.01f, 1.0f, value(averagingWeightID));
+    settings.rmsLength = juce::jlimit(1, SpectrumAverager::maxRMSFrames, index(rmsLengthID));
+    settings.peakDecay = value(peakDecayID);
+    settings.smoothingFraction = SpectrumSmoother::fractions[static_cast<size_t>(
+        juce::jlimit(0, static_cast<int>(SpectrumSmoother::fractions.size()) - 1, index(smoothingID)))];
+    settings.noiseCalibration = value(noiseCalibrationID) >= 0.5f;
+    settings.targetCurve = static_cast<SpectrumTargets::Genre>(index(targetCurveID));
+
+    // Keep at least 20 dB on screen whichever end was moved
+    settings.displayFloor = value(displayFloorID);
+    settings.displayCeiling = juce::jmax(value(displayCeilingID), settings.displayFloor + 20.0f);
+
+    settings.loudnessTarget = value(loudnessTargetID);
+    settings.loudnessTolerance = value(loudnessToleranceID);
+    return settings;
+}
+
+//==============================================================================
+AnalyzerSettingsPublisher::AnalyzerSettingsPublisher()
+{
+    publish({});
+}
+
+AnalyzerSettingsPublisher::~AnalyzerSettingsPublisher()
+{
+    // Readers belong to objects that must be gone by now
+    jassert(std::none_of(readers.begin(), readers.end(), [](const auto& reader) { return reader.inUse; }));
+}
+
+void AnalyzerSettingsPublisher::publish(const AnalyzerSettings& settings)
+{
+    auto snapshot = std::make_unique<AnalyzerSettings>(settings);
+    snapshot->version = nextVersion++;
+
+    latest.store(snapshot.get(), std::memory_order_release);
+    snapshots.push_back(std::move(snapshot));
+
+    freeAcknowledged();
+}
+
+void AnalyzerSettingsPublisher::freeAcknowledged()
+{
+    // Everything older than the oldest version still in use can go; the
+    // latest always stays
+    auto oldestInUse = snapshots.back()->version;
+
+    for (const auto& reader : readers)
+        if (reader.inUse)
+            oldestInUse = juce::jmin(oldestInUse, reader.acknowledged.load(std::memory_order_acquire));
+
+    const auto firstKept = std::find_if(snapshots.begin(), snapshots.end(),
+                                        [oldestInUse](const auto& s) { return s->version >= oldestInUse; });
+    snapshots.erase(snapshots.begin(), firstKept);
+}
+
+int AnalyzerSettingsPublisher::claimReaderSlot()
+{
+    for (int i = 0; i < maxReaders; ++i)
+    {
+        auto& reader = readers[static_cast<size_t>(i)];
+
+        if (! reader.inUse)
+        {
+            reader.inUse = true;
+            reader.acknowledged.store(snapshots.back()->version);
+            return i;
+        }
+    }
+
+    // Raise maxReaders
+    jassertfalse;
+    return -1;
+}
+
+//==============================================================================
+AnalyzerSettingsPublisher::Reader::Reader(AnalyzerSettingsPublisher& publisher)
+    : owner(publisher),
+      slot(publisher.claimReaderSlot()),
+      current(publisher.snapshots.back().get())
+{
+}
+
+AnalyzerSettingsPublisher::Reader::~Reader()
+{
+    if (slot >= 0)
+        owner.readers[static_cast<size_t>(slot)].inUse = false;
+}
+
+bool AnalyzerSettingsPublisher::Reader::update() noexcept
+{
+    const auto* newest = owner.latest.load(std::memory_order_acquire);
+
+    if (newest == current)
+        return false;
+
+    // Using it before acknowledging is safe: the publisher only frees what
+    // is older than the version acknowledged so far
+    current = newest;
+
+    if (slot >= 0)
+        owner.readers[static_cast<size_t>(slot)].acknowledged.store(current->version, std::memory_order_release);
+
+    return true;
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+    Host-automatable analyzer settings and their immutable snapshots.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "SpectrumAverager.h"
+#include "SpectrumTargets.h"
+
+//==============================================================================
+// Every user setting the analysis and display depend on, read together from
+// the parameters. A published snapshot is never modified.
+struct AnalyzerSettings
+{
+    enum class WindowType { hann = 0, blackmanHarris, flatTop, kaiser };
+    enum class ChannelMode { leftRight = 0, midSide };
+
+    static constexpr int minFFTOrder = 9;   // 512
+    static constexpr int maxFFTOrder = 15;  // 32768
+
+    int fftOrder = 11;
+    WindowType windowType = WindowType::hann;
+    ChannelMode channelMode = ChannelMode::leftRight;
+    SpectrumAverager::Mode averagingMode = SpectrumAverager::Mode::exponential;
+    float averagingWeight = 0.15f;          // exponential: share of each new frame
+    int rmsLength = 8;                      // RMS: frames in the moving average
+    float peakDecay = 12.0f;                // peak hold fall rate, dB per second
+    int smoothingFraction = 0;              // 1/N octave, 0 = off
+    bool noiseCalibration = false;
+    SpectrumTargets::Genre targetCurve = SpectrumTargets::Genre::none;
+
+    // Spectrum display range, dB
+    float displayFloor = -80.0f;
+    float displayCeiling = 0.0f;
+
+    // Short-term loudness target for tips and events
+    float loudnessTarget = -14.0f;
+    float loudnessTolerance = 3.0f;
+
+    juce::uint32 version = 0;               // set when published
+
+    // Parameter IDs, in layout order. New ones go at the end, so hosts that
+    // address parameters by index keep their automation.
+    static constexpr const char* fftSizeID = "fftSize";
+    static constexpr const char* windowID = "window";
+    static constexpr const char* channelModeID = "channelMode";
+    static constexpr const char* averagingID = "averaging";
+    static constexpr const char* smoothingID = "smoothing";
+    static constexpr const char* noiseCalibrationID = "noiseCalibration";
+    static constexpr const char* targetCurveID = "targetCurve";
+    static constexpr const char* displayFloorID = "displayFloor";
+    static constexpr const char* displayCeilingID = "displayCeiling";
+    static constexpr const char* loudnessTargetID = "loudnessTarget";
+    static constexpr const char* loudnessToleranceID = "loudnessTolerance";
+    static constexpr const char* averagingWeightID = "averagingWeight";
+    static constexpr const char* rmsLengthID = "rmsLength";
+    static constexpr const char* peakDecayID = "peakDecay";
+    static const std::array<const char*, 14> parameterIDs;
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Message thread
+    static AnalyzerSettings fromParameters(const juce::AudioProcessorValueTreeState& parameters);
+};
+
+//==============================================================================
+// Hands settings from the message thread to the analysis threads. Each
+// publish() makes a new immutable snapshot and swaps it in with one atomic
+// pointer store; a reader picks it up with one atomic load, so a thread only
+// pays for settings when they have actually changed, however many parameters
+// there are or however often the host automates them.
+//
+// Each reading thread owns a Reader, which acknowledges the version it is
+// using. A snapshot is freed on the message thread only once every reader
+// has acknowledged a later one, so readers never take a lock or see a
+// snapshot disappear under them.
+class AnalyzerSettingsPublisher
+{
+public:
+    static constexpr int maxReaders = 4;
+
+    AnalyzerSettingsPublisher();
+    ~AnalyzerSettingsPublisher();
+
+    // Message thread
+    void publish(const AnalyzerSettings& settings);
+    const AnalyzerSettings& getLatest() const { return *snapshots.back(); }
+
+    class Reader
+    {
+    public:
+        // Message thread
+        explicit Reader(AnalyzerSettingsPublisher& publisher);
+        ~Reader();
+
+        // Reading thread: true if a newer snapshot was picked up
+        bool update() noexcept;
+        const AnalyzerSettings& get() const noexcept { return *current; }
+        const AnalyzerSettings* operator->() const noexcept { return current; }
+
+    private:
+        AnalyzerSettingsPublisher& owner;
+        const int slot;
+        const AnalyzerSettings* current;
+
+        JUCE_DECLARE_NON_COPYABLE(Reader)
+    };
+
+private:
+    int claimReaderSlot();
+    void freeAcknowledged();
+
+    std::atomic<const AnalyzerSettings*> latest{ nullptr };
+
+    // Message thread: everything published and not yet freed, oldest first
+    std::vector<std::unique_ptr<AnalyzerSettings>> snapshots;
+    juce::uint32 nextVersion = 1;
+
+    struct ReaderSlot
+    {
+        bool inUse = false;                         // message thread
+        std::atomic<juce::uint32> acknowledged{ 0 };
+    };
+
+    std::array<ReaderSlot, maxReaders> readers;
+
+    JUCE_DECLARE_NON_COPYABLE(AnalyzerSettingsPublisher)
+};
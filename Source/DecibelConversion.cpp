@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+    Fast linear-to-dB conversion for meter and display paths.
+  ==============================================================================
+*/
+
+#include "DecibelConversion.h"
+
+namespace
+{
+    template <int scale>
+    void toDecibels(float* dest, const float* source, int numValues, float floorDecibels) noexcept
+    {
+        const float minimum = juce::jmax(std::pow(10.0f, floorDecibels / static_cast<float>(scale)),
+                                         std::numeric_limits<float>::min());
+        constexpr float factor = static_cast<float>(scale) * 0.30102999566f;
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            const float x = source[i] > minimum ? source[i] : minimum;
+            dest[i] = factor * DecibelConversion::fastLog2(x);
+        }
+    }
+}
+
+void DecibelConversion::powerToDecibels(float* dest, const float* power, int numValues, float floorDecibels) noexcept
+{
+    toDecibels<10>(dest, power, numValues, floorDecibels);
+}
+
+void DecibelConversion::gainToDecibels(float* dest, const float* gain, int numValues, float floorDecibels) noexcept
+{
+    toDecibels<20>(dest, gain, numValues, floorDecibels);
+}
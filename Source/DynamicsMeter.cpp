@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+    Programme dynamics: crest factor and a DR-style dynamic range score.
+  ==============================================================================
+*/
+
+#include "DynamicsMeter.h"
+
+//==============================================================================
+void DynamicsMeter::prepare(double sampleRate)
+{
+    requestedBlockLength.store(juce::jmax(1, juce::roundToInt(sampleRate * 3.0)));
+}
+
+void DynamicsMeter::reset()
+{
+    programSumSquares = 0.0;
+    programSamples = 0;
+    programPeak = 0.0f;
+    blockSumSquares = 0.0;
+    blockSamples = 0;
+    blockPeak = 0.0f;
+    histogram.fill({});
+    numBlocks = 0;
+    highestPeak = 0.0f;
+    secondPeak = 0.0f;
+
+    programPeakOut.store(0.0f);
+    programMeanSquareOut.store(0.0f);
+    rangePeakOut.store(0.0f);
+    rangeMeanSquareOut.store(0.0f);
+}
+
+void DynamicsMeter::addSubBlock(double meanSquareSum, float peak, int numSamples)
+{
+    if (const int requested = requestedBlockLength.load(std::memory_order_relaxed); requested != blockLength)
+    {
+        blockLength = requested;
+        reset();
+    }
+
+    if (blockLength == 0 || numSamples <= 0)
+        return;
+
+    programSumSquares += meanSquareSum;
+    programSamples += numSamples;
+    programPeak = juce::jmax(programPeak, peak);
+
+    programPeakOut.store(programPeak, std::memory_order_relaxed);
+    programMeanSquareOut.store(static_cast<float>(programSumSquares / static_cast<double>(programSamples)),
+                               std::memory_order_relaxed);
+
+    // Sub-blocks are far shorter than a DR block, so a block may overrun
+    // its 3 s by one sub-block - not enough to matter
+    blockSumSquares += meanSquareSum;
+    blockSamples += numSamples;
+    blockPeak = juce::jmax(blockPeak, peak);
+
+    if (blockSamples >= blockLength)
+        finishBlock();
+}
+
+void DynamicsMeter::finishBlock()
+{
+    const double rmsSquared = 2.0 * blockSumSquares / blockSamples;
+    const double level = DecibelConversion::powerToDecibels(static_cast<float>(rmsSquared), static_cast<float>(histogramFloordB));
+    const int bin = juce::jlimit(0, numHistogramBins - 1, static_cast<int>((level - histogramFloordB) / histogramStepdB));
+
+    histogram[static_cast<size_t>(bin)].energy += rmsSquared;
+    ++histogram[static_cast<size_t>(bin)].count;
+    ++numBlocks;
+
+    if (blockPeak > highestPeak)
+    {
+        secondPeak = highestPeak;
+        highestPeak = blockPeak;
+    }
+    else if (blockPeak > secondPeak)
+    {
+        secondPeak = blockPeak;
+    }
+
+    blockSumSquares = 0.0;
+    blockSamples = 0;
+    blockPeak = 0.0f;
+
+    updateDynamicRange();
+}
+
+void DynamicsMeter::updateDynamicRange()
+{
+    // Mean RMS^2 of the loudest 20% of blocks, from the top of the histogram
+    const int wanted = juce::jmax(1, numBlocks / 5);
+    int taken = 0;
+    double energy = 0.0;
+
+    for (int bin = numHistogramBins - 1; bin >= 0 && taken < wanted; --bin)
+    {
+        const auto& entry = histogram[static_cast<size_t>(bin)];
+        if (entry.count == 0)
+            continue;
+
+        // Part of a bin counts at the bin's mean
+        const int count = juce::jmin(entry.count, wanted - taken);
+        energy += entry.energy * count / entry.count;
+        taken += count;
+    }
+
+    const float peak = numBlocks > 1 ? secondPeak : highestPeak;
+
+    if (energy <= 0.0 || peak <= 0.0f)
+        return;
+
+    rangePeakOut.store(peak, std::memory_order_relaxed);
+    rangeMeanSquareOut.store(static_cast<float>(energy / taken), std::memory_order_relaxed);
+}
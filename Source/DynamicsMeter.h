@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+    Programme dynamics: crest factor and a DR-style dynamic range score.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "DecibelConversion.h"
+
+//==============================================================================
+// Fed with the energy and peak the processor already gathers per sub-block,
+// so there is no pass over the audio of its own; every update is constant
+// time. Crest factor is programme peak over programme RMS. The DR score
+// follows the usual DR meter recipe: 3 s blocks, RMS taken as sqrt(2 x mean
+// square) so a sine reads 0, the loudest 20% of blocks against the second
+// highest block peak. The blocks go into a fixed 0.1 dB histogram, so the
+// loudest 20% never needs a sort and nothing grows with the programme.
+// The audio thread publishes linear levels; the getters convert to dB.
+class DynamicsMeter
+{
+public:
+    // Message thread. A new sample rate starts the statistics again.
+    void prepare(double sampleRate);
+
+    // Audio thread: meanSquareSum is the sum of squares over the block,
+    // averaged over the channels
+    void addSubBlock(double meanSquareSum, float peak, int numSamples);
+
+    // dB; 0 until there is something to measure
+    float getCrestFactor() const { return peakToRMSDecibels(programPeakOut.load(), programMeanSquareOut.load()); }
+    float getDynamicRange() const { return peakToRMSDecibels(rangePeakOut.load(), rangeMeanSquareOut.load()); }
+
+private:
+    static constexpr double histogramFloordB = -100.0;
+    static constexpr double histogramStepdB = 0.1;
+    static constexpr int numHistogramBins = 1100;   // up to +10 dB
+
+    struct HistogramBin
+    {
+        double energy = 0.0;
+        int count = 0;
+    };
+
+    void reset();
+    void finishBlock();
+    void updateDynamicRange();
+
+    // The two halves of a reading are stored separately, so a getter may
+    // pair a peak with the previous mean square - for one display frame
+    static float peakToRMSDecibels(float peak, float meanSquare)
+    {
+        if (peak <= 0.0f || meanSquare <= 0.0f)
+            return 0.0f;
+
+        return DecibelConversion::gainToDecibels(peak, noFloorDecibels)
+             - DecibelConversion::powerToDecibels(meanSquare, noFloorDecibels);
+    }
+
+    static constexpr float noFloorDecibels = -1000.0f;
+
+    std::atomic<int> requestedBlockLength{ 0 };
+    int blockLength = 0;
+
+    // Audio-thread state
+    double programSumSquares = 0.0;
+    juce::int64 programSamples = 0;
+    float programPeak = 0.0f;
+
+    double blockSumSquares = 0.0;
+    int blockSamples = 0;
+    float blockPeak = 0.0f;
+
+    std::array<HistogramBin, numHistogramBins> histogram{};
+    int numBlocks = 0;
+    float highestPeak = 0.0f, secondPeak = 0.0f;
+
+    // Published for the getters: programme peak and mean square, and the
+    // DR peak against the mean RMS^2 of the loudest blocks
+    std::atomic<float> programPeakOut{ 0.0f }, programMeanSquareOut{ 0.0f };
+    std::atomic<float> rangePeakOut{ 0.0f }, rangeMeanSquareOut{ 0.0f };
+};
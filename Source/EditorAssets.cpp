@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+    UI resources shared by every editor in the process.
+  ==============================================================================
+*/
+
+#include "EditorAssets.h"
+#include <algorithm>
+
+//==============================================================================
+const MeterGlyphAtlas& EditorAssets::getGlyphAtlas()
+{
+    if (glyphAtlas == nullptr)
+        glyphAtlas = std::make_unique<MeterGlyphAtlas>(12.0f);
+
+    return *glyphAtlas;
+}
+
+const juce::Font& EditorAssets::getTitleFont()
+{
+    if (titleFont == nullptr)
+        titleFont = std::make_unique<juce::Font>(juce::FontOptions(14.0f, juce::Font::bold));
+
+    return *titleFont;
+}
+
+const juce::Image& EditorAssets::getBackground(int width, int height, BackgroundRenderer render)
+{
+    if (! background.isValid() || width != backgroundWidth || height != backgroundHeight)
+    {
+        backgroundWidth = width;
+        backgroundHeight = height;
+
+        // Opaque, and at twice the size so the title stays sharp on high-DPI displays
+        background = juce::Image(juce::Image::RGB, juce::jmax(1, width * 2), juce::jmax(1, height * 2), false);
+        juce::Graphics g(background);
+        g.addTransform(juce::AffineTransform::scale(2.0f));
+        render(g, width, height);
+    }
+
+    return background;
+}
+
+//==============================================================================
+void EditorAssets::storeFrame(const void* owner, const juce::Image& frame)
+{
+    forgetFrame(owner);
+
+    if (! frame.isValid())
+        return;
+
+    if (static_cast<int>(frames.size()) >= maxCachedFrames)
+        frames.erase(frames.begin());
+
+    frames.push_back({ owner, frame });
+}
+
+juce::Image EditorAssets::getFrame(const void* owner) const
+{
+    const auto found = std::find_if(frames.begin(), frames.end(),
+                                    [owner](const CachedFrame& cached) { return cached.owner == owner; });
+
+    return found != frames.end() ? found->image : juce::Image();
+}
+
+void EditorAssets::forgetFrame(const void* owner)
+{
+    frames.erase(std::remove_if(frames.begin(), frames.end(),
+                                [owner](const CachedFrame& cached) { return cached.owner == owner; }),
+                 frames.end());
+}
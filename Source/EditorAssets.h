@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+    UI resources shared by every editor in the process.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "MeterComponents.h"
+
+//==============================================================================
+// The glyph atlas, the section title font and the pre-rendered background
+// are built the first time an editor asks for them and then reused by every
+// editor, so opening one renders no text or gradients that another editor
+// has already drawn. The last frame of recently closed editors is kept too,
+// so an editor that is opened again can show it at once while its controls
+// are being built.
+//
+// Each processor holds the assets through a juce::SharedResourcePointer, so
+// they survive editors coming and going. Nothing is built until an editor
+// opens, so they cost nothing in a headless render. Message thread only.
+class EditorAssets
+{
+public:
+    EditorAssets() = default;
+
+    const MeterGlyphAtlas& getGlyphAtlas();
+    const juce::Font& getTitleFont();
+
+    // Rendered at twice the size by 'render' the first time, and again
+    // only if the size changes
+    using BackgroundRenderer = void (*)(juce::Graphics&, int width, int height);
+    const juce::Image& getBackground(int width, int height, BackgroundRenderer render);
+
+    // Last frame of an instance's editor, keyed by its processor. Only the
+    // most recent few are kept, as each is a full-size image.
+    static constexpr int maxCachedFrames = 8;
+    void storeFrame(const void* owner, const juce::Image& frame);
+    juce::Image getFrame(const void* owner) const;
+    void forgetFrame(const void* owner);
+
+private:
+    std::unique_ptr<MeterGlyphAtlas> glyphAtlas;
+    std::unique_ptr<juce::Font> titleFont;
+    juce::Image background;
+    int backgroundWidth = 0, backgroundHeight = 0;
+
+    // Least recently stored first
+    struct CachedFrame
+    {
+        const void* owner;
+        juce::Image image;
+    };
+
+    std::vector<CachedFrame> frames;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditorAssets)
+};
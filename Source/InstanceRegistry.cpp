@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+    Process-wide registry of TrackTweak instances and their latest meters.
+  ==============================================================================
+*/
+
+#include "InstanceRegistry.h"
+
+//==============================================================================
+void InstanceRegistry::Entry::setName(const juce::String& newName)
+{
+    const juce::SpinLock::ScopedLockType lock(nameLock);
+    name = newName;
+}
+
+juce::String InstanceRegistry::Entry::getName() const
+{
+    const juce::SpinLock::ScopedLockType lock(nameLock);
+    return name;
+}
+
+//==============================================================================
+InstanceRegistry& InstanceRegistry::getInstance()
+{
+    static InstanceRegistry registry;
+    return registry;
+}
+
+InstanceRegistry::Entry* InstanceRegistry::join()
+{
+    for (int i = 0; i < maxInstances; ++i)
+    {
+        auto& entry = entries[static_cast<size_t>(i)];
+        bool expected = false;
+
+        if (! entry.inUse.load(std::memory_order_relaxed)
+            && entry.inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            // Values left by the previous owner must not show up under the new one
+            entry.snapshot.momentaryLUFS.store(-70.0f);
+            entry.snapshot.shortTermLUFS.store(-70.0f);
+            entry.snapshot.integratedLUFS.store(-70.0f);
+            entry.snapshot.peak.store(0.0f);
+            entry.snapshot.maxPeak.store(0.0f);
+            entry.setName("TrackTweak " + juce::String(i + 1));
+
+            auto mark = highWaterMark.load();
+            while (mark < i + 1 && ! highWaterMark.compare_exchange_weak(mark, i + 1)) {}
+
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void InstanceRegistry::leave(Entry* entry)
+{
+    if (entry != nullptr)
+        entry->inUse.store(false, std::memory_order_release);
+}
+
+void InstanceRegistry::collectActive(std::vector<Entry*>& destination)
+{
+    const int numToScan = highWaterMark.load(std::memory_order_acquire);
+
+    for (int i = 0; i < numToScan; ++i)
+    {
+        auto& entry = entries[static_cast<size_t>(i)];
+
+        if (entry.inUse.load(std::memory_order_acquire))
+            destination.push_back(&entry);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+    Process-wide registry of TrackTweak instances and their latest meters.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+// Every instance loaded in this process (the plugin binary is loaded once by
+// the host, so they all see the same registry) claims one entry. Entries
+// live in a fixed static array and are never freed, so a reader holding an
+// entry pointer can never see it dangle - at worst it reads an entry that
+// has just been released. Joining and leaving are a CAS and a store.
+class InstanceRegistry
+{
+public:
+    // Latest meter values of one instance, written by its analysis worker
+    struct MeterSnapshot
+    {
+        std::atomic<float> momentaryLUFS{ -70.0f };
+        std::atomic<float> shortTermLUFS{ -70.0f };
+        std::atomic<float> integratedLUFS{ -70.0f };
+        std::atomic<float> peak{ 0.0f };
+        std::atomic<float> maxPeak{ 0.0f };
+    };
+
+    struct Entry
+    {
+        std::atomic<bool> inUse{ false };
+        MeterSnapshot snapshot;
+
+        // Set and read rarely; the lock covers hosts that report track
+        // names off the message thread
+        void setName(const juce::String& newName);
+        juce::String getName() const;
+
+    private:
+        juce::SpinLock nameLock;
+        juce::String name;
+    };
+
+    static constexpr int maxInstances = 1024;
+
+    static InstanceRegistry& getInstance();
+
+    // Null when every entry is taken; the instance then simply isn't listed
+    Entry* join();
+    void leave(Entry* entry);
+
+    // Appends every entry in use to 'destination', which should have
+    // maxInstances reserved so this never allocates. Scans only as far as
+    // the highest entry ever claimed.
+    void collectActive(std::vector<Entry*>& destination);
+
+private:
+    InstanceRegistry() = default;
+
+    std::array<Entry, maxInstances> entries;
+    std::atomic<int> highWaterMark{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(InstanceRegistry)
+};
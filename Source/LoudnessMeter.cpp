@@ -0,0 +1,608 @@
+/*
+  ==============================================================================
+    Momentary / short-term / integrated loudness measurement.
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+namespace
+{
+    constexpr double absoluteGateLUFS = -70.0;
+    constexpr double integratedRelativeGateLU = -10.0;   // BS.1770-4
+    constexpr double rangeRelativeGateLU = -20.0;        // EBU Tech 3342
+
+    // Zeroth-order modified Bessel function, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+//==============================================================================
+LoudnessMeter::Config::Config(double rate)
+    : sampleRate(rate),
+      samplesPerBlock(juce::jmax(1, juce::roundToInt(rate * 0.1)))
+{
+    // BS.1770 K-weighting, redesigned for this rate from its analogue
+    // prototypes (matches the published 48 kHz coefficients)
+    {
+        const double f0 = 1681.974450955533, gaindB = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+        const double vh = std::pow(10.0, gaindB / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        preFilter = { (vh + vb * k / q + k * k) / a0,
+                      2.0 * (k * k - vh) / a0,
+                      (vh - vb * k / q + k * k) / a0,
+                      2.0 * (k * k - 1.0) / a0,
+                      (1.0 - k / q + k * k) / a0 };
+    }
+
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        rlbFilter = { 1.0, -2.0, 1.0,
+                      2.0 * (k * k - 1.0) / a0,
+                      (1.0 - k / q + k * k) / a0 };
+    }
+
+    // True peak: Kaiser-windowed sinc interpolator cut off at the input
+    // Nyquist frequency, split into one 16-tap phase per output sample.
+    // The sinc is centred on a tap, so phase 0 is the input sample itself
+    // and the reading never falls below the sample peak. Each phase is
+    // scaled to unity gain at DC, which keeps the in-band ripple of the
+    // short kernel out of the reading.
+    oversampling = rate < 96000.0 ? 4 : (rate < 192000.0 ? 2 : 1);
+
+    if (oversampling > 1)
+    {
+        const int numTaps = truePeakTapsPerPhase * oversampling;
+        const int centre = numTaps / 2;
+        const double beta = 8.0;
+
+        for (int n = 0; n < numTaps; ++n)
+        {
+            const double x = static_cast<double>(n - centre) / oversampling;
+            const double sinc = n == centre ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+            const double ratio = static_cast<double>(n - centre) / centre;
+            const double window = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+
+            const int phase = n % oversampling;
+            const int tap = n / oversampling;
+            truePeakCoefficients[static_cast<size_t>(phase * truePeakTapsPerPhase + tap)] = static_cast<float>(sinc * window);
+        }
+
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            auto* h = truePeakCoefficients.data() + phase * truePeakTapsPerPhase;
+            float gain = 0.0f;
+
+            for (int tap = 0; tap < truePeakTapsPerPhase; ++tap)
+                gain += h[tap];
+
+            for (int tap = 0; tap < truePeakTapsPerPhase; ++tap)
+                h[tap] /= gain;
+        }
+    }
+}
+
+//==============================================================================
+void LoudnessMeter::GatedHistogram::clear()
+{
+    bins.fill({});
+    energy = 0.0;
+    count = 0;
+}
+
+void LoudnessMeter::GatedHistogram::add(double blockEnergy)
+{
+    const double loudness = energyToLUFS(blockEnergy);
+    if (loudness <= absoluteGateLUFS)
+        return;
+
+    const int bin = juce::jlimit(0, numHistogramBins - 1,
+        static_cast<int>((loudness - absoluteGateLUFS) / histogramStep));
+
+    bins[static_cast<size_t>(bin)].energy += blockEnergy;
+    ++bins[static_cast<size_t>(bin)].count;
+    energy += blockEnergy;
+    ++count;
+}
+
+int LoudnessMeter::GatedHistogram::firstBinAbove(double relativeGateLU) const
+{
+    const double gate = energyToLUFS(energy / static_cast<double>(count)) + relativeGateLU;
+    return juce::jlimit(0, numHistogramBins, static_cast<int>(std::ceil((gate - absoluteGateLUFS) / histogramStep)));
+}
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter()
+{
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    delete pendingConfig.exchange(nullptr);
+    delete retiredConfig.exchange(nullptr);
+    delete activeConfig;
+}
+
+void LoudnessMeter::prepare(double sampleRate)
+{
+    // Whatever the audio thread retired last time can go now
+    delete retiredConfig.exchange(nullptr);
+
+    if (sampleRate == preparedSampleRate)
+        return;
+
+    preparedSampleRate = sampleRate;
+
+    // A config the audio thread never picked up is simply superseded
+    delete pendingConfig.exchange(new Config(sampleRate));
+}
+
+void LoudnessMeter::adoptPendingConfig()
+{
+    // Only swap when the retire slot is free, so nothing is ever freed here
+    if (pendingConfig.load(std::memory_order_relaxed) == nullptr
+        || retiredConfig.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    auto* next = pendingConfig.exchange(nullptr, std::memory_order_acq_rel);
+    if (next == nullptr)
+        return;
+
+    const bool rateChanged = activeConfig == nullptr || activeConfig->sampleRate != next->sampleRate;
+
+    retiredConfig.store(activeConfig, std::memory_order_release);
+    activeConfig = next;
+
+    if (rateChanged)
+        resetHistory();
+}
+
+void LoudnessMeter::resetHistory()
+{
+    channelStates.fill({});
+    blockSumSquares = 0.0;
+    blockSampleCount = 0;
+    blockLength = activeConfig->samplesPerBlock;
+    blockTruePeak = 0.0f;
+    recentTruePeak = 0.0f;
+    blockPlainSum = 0.0;
+    timelineBlock = -1;
+    expectedPosition = -1;
+    blockOnGrid = false;
+    blockSums.fill(0.0);
+    blockCounts.fill(activeConfig->samplesPerBlock);
+    blockPeaks.fill(0.0f);
+    blockWritePos = 0;
+    blocksSeen = 0;
+    momentaryHistogram.clear();
+    shortTermHistogram.clear();
+    query = {};
+
+    momentaryLUFS.store(silenceLUFS);
+    shortTermLUFS.store(silenceLUFS);
+    integratedLUFS.store(silenceLUFS);
+    loudnessRange.store(0.0f);
+    truePeak.store(0.0f);
+    shortTermTruePeak.store(0.0f);
+}
+
+//==============================================================================
+template <typename SampleType>
+void LoudnessMeter::process(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    adoptPendingConfig();
+
+    if (activeConfig == nullptr)
+        return;
+
+    numChannels = juce::jmin(numChannels, maxChannels);
+    if (numChannels <= 0)
+        return;
+
+    int sample = 0;
+
+    while (sample < numSamples)
+    {
+        const int count = juce::jmin(numSamples - sample, blockLength - blockSampleCount);
+
+        float chunkTruePeak = 0.0f;
+
+        // BS.1770 sums the weighted mean squares of the channels (G = 1 for L/R)
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto& state = channelStates[static_cast<size_t>(channel)];
+            const SampleType* data = channels[channel] + sample;
+
+            blockSumSquares += weightChannel(state, data, count, blockPlainSum);
+            chunkTruePeak = juce::jmax(chunkTruePeak, findTruePeak(state, data, count));
+        }
+
+        blockTruePeak = juce::jmax(blockTruePeak, chunkTruePeak);
+        recentTruePeak = juce::jmax(recentTruePeak, chunkTruePeak);
+
+        blockSampleCount += count;
+        sample += count;
+
+        if (blockSampleCount == blockLength)
+            finishBlock(blockOnGrid);
+    }
+
+    // Twice the rate that finishes all three scans within one block
+    continueQueries(juce::jmax(64, 6 * numHistogramBins * numSamples / blockLength));
+
+    if (expectedPosition >= 0)
+        expectedPosition += numSamples;
+}
+
+void LoudnessMeter::setTimelinePosition(juce::int64 samplePosition)
+{
+    adoptPendingConfig();
+
+    // Pre-roll before the timeline start counts as unknown
+    samplePosition = juce::jmax(samplePosition, juce::int64(-1));
+
+    if (activeConfig == nullptr || samplePosition == expectedPosition)
+        return;
+
+    // Stopped, or a jump: the block being filled belongs to neither side
+    if (blockSampleCount > 0)
+        finishBlock(false);
+
+    const int samplesPerBlock = activeConfig->samplesPerBlock;
+    expectedPosition = samplePosition;
+
+    if (samplePosition < 0)
+    {
+        timelineBlock = -1;
+        blockLength = samplesPerBlock;
+        blockOnGrid = false;
+        return;
+    }
+
+    discontinuities.fetch_add(1, std::memory_order_relaxed);
+
+    // Run up to the next grid line; that first block only counts if the
+    // jump landed exactly on one
+    const auto offset = static_cast<int>(samplePosition % samplesPerBlock);
+    timelineBlock = samplePosition / samplesPerBlock;
+    blockLength = samplesPerBlock - offset;
+    blockOnGrid = offset == 0;
+}
+
+int LoudnessMeter::readBlockRecords(BlockRecord* destination, int maxRecords)
+{
+    const auto scope = recordFifo.read(juce::jmin(maxRecords, recordFifo.getNumReady()));
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        destination[i] = records[static_cast<size_t>(scope.startIndex1 + i)];
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        destination[scope.blockSize1 + i] = records[static_cast<size_t>(scope.startIndex2 + i)];
+
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+template void LoudnessMeter::process<float>(const float* const*, int, int);
+template void LoudnessMeter::process<double>(const double* const*, int, int);
+
+template <typename SampleType>
+double LoudnessMeter::weightChannel(ChannelState& state, const SampleType* data, int numSamples, double& plainSum) const
+{
+    const auto pre = activeConfig->preFilter;
+    const auto rlb = activeConfig->rlbFilter;
+    double pre1 = state.pre1, pre2 = state.pre2, rlb1 = state.rlb1, rlb2 = state.rlb2;
+    double sum = 0.0, plain = 0.0;
+
+    // Two transposed direct-form II biquads in double precision
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double x = static_cast<double>(data[i]);
+        plain += x;
+
+        const double y = pre.b0 * x + pre1;
+        pre1 = pre.b1 * x - pre.a1 * y + pre2;
+        pre2 = pre.b2 * x - pre.a2 * y;
+
+        const double z = rlb.b0 * y + rlb1;
+        rlb1 = rlb.b1 * y - rlb.a1 * z + rlb2;
+        rlb2 = rlb.b2 * y - rlb.a2 * z;
+
+        sum += z * z;
+    }
+
+    state.pre1 = pre1;
+    state.pre2 = pre2;
+    state.rlb1 = rlb1;
+    state.rlb2 = rlb2;
+
+    plainSum += plain;
+    return sum;
+}
+
+template <typename SampleType>
+float LoudnessMeter::findTruePeak(ChannelState& state, const SampleType* data, int numSamples) const
+{
+    const int oversampling = activeConfig->oversampling;
+    float peak = 0.0f;
+
+    if (oversampling == 1)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            peak = juce::jmax(peak, std::abs(static_cast<float>(data[i])));
+
+        return peak;
+    }
+
+    auto& history = state.truePeakHistory;
+    const auto* coefficients = activeConfig->truePeakCoefficients.data();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = static_cast<float>(data[i]);
+        const auto pos = static_cast<size_t>(state.truePeakPos);
+
+        history[pos] = x;
+        history[pos + truePeakTapsPerPhase] = x;
+        state.truePeakPos = (state.truePeakPos + 1) % truePeakTapsPerPhase;
+
+        // Phase 0 is the input sample, delayed by half the kernel
+        peak = juce::jmax(peak, std::abs(x));
+
+        // Newest sample last: window = history[pos + 1 .. pos + taps]
+        const float* window = history.data() + pos + 1;
+
+        for (int phase = 1; phase < oversampling; ++phase)
+        {
+            const float* h = coefficients + phase * truePeakTapsPerPhase;
+            float y = 0.0f;
+
+            for (int tap = 0; tap < truePeakTapsPerPhase; ++tap)
+                y += h[tap] * window[truePeakTapsPerPhase - 1 - tap];
+
+            peak = juce::jmax(peak, std::abs(y));
+        }
+    }
+
+    return peak;
+}
+
+//==============================================================================
+void LoudnessMeter::finishBlock(bool complete)
+{
+    const double blockEnergy = blockSumSquares / blockSampleCount;
+
+    if (blockTruePeak > truePeak.load(std::memory_order_relaxed))
+        truePeak.store(blockTruePeak);
+
+    // A full reader just misses blocks; the cache fills them on the next pass
+    if (timelineBlock >= 0 && recordFifo.getFreeSpace() > 0)
+    {
+        const auto scope = recordFifo.write(1);
+        records[static_cast<size_t>(scope.startIndex1)] = { timelineBlock, activeConfig->samplesPerBlock, complete, blockEnergy,
+                                                            blockTruePeak, static_cast<float>(blockPlainSum) };
+    }
+
+    // Only a full block is a 100 ms step of the gating windows; a short
+    // one still counts, by its length, in the windows that contain it
+    const bool fullLength = blockSampleCount == activeConfig->samplesPerBlock;
+
+    blockSums[static_cast<size_t>(blockWritePos)] = blockSumSquares;
+    blockCounts[static_cast<size_t>(blockWritePos)] = blockSampleCount;
+    blockPeaks[static_cast<size_t>(blockWritePos)] = blockTruePeak;
+    blockWritePos = (blockWritePos + 1) % shortTermBlocks;
+    blockSumSquares = 0.0;
+    blockSampleCount = 0;
+    blockTruePeak = 0.0f;
+    blockPlainSum = 0.0;
+    blockLength = activeConfig->samplesPerBlock;
+    ++blocksSeen;
+
+    if (timelineBlock >= 0)
+    {
+        ++timelineBlock;
+        blockOnGrid = true;
+    }
+
+    // Sum the newest blocks, walking backwards from the write position
+    double momentarySum = 0.0, shortTermSum = 0.0;
+    juce::int64 momentaryCount = 0, shortTermCount = 0;
+
+    for (int i = 1; i <= shortTermBlocks; ++i)
+    {
+        const auto slot = static_cast<size_t>((blockWritePos - i + shortTermBlocks) % shortTermBlocks);
+        shortTermSum += blockSums[slot];
+        shortTermCount += blockCounts[slot];
+
+        if (i <= momentaryBlocks)
+        {
+            momentarySum += blockSums[slot];
+            momentaryCount += blockCounts[slot];
+        }
+    }
+
+    const double momentaryEnergy = momentarySum / static_cast<double>(momentaryCount);
+    const double shortTermEnergy = shortTermSum / static_cast<double>(shortTermCount);
+
+    momentaryLUFS.store(energyToLUFS(momentaryEnergy));
+    shortTermLUFS.store(energyToLUFS(shortTermEnergy));
+    shortTermTruePeak.store(*std::max_element(blockPeaks.begin(), blockPeaks.end()));
+
+    // Gating blocks are 400 ms windows stepped by 100 ms (75% overlap);
+    // range uses 3 s windows at the same step. Partial windows don't count.
+    // The histograms only change here, so a query still running from the
+    // last block is finished against them first
+    if (query.stage != QueryStage::idle)
+        continueQueries(std::numeric_limits<int>::max());
+
+    const bool addMomentary = fullLength && blocksSeen >= momentaryBlocks;
+    const bool addShortTerm = fullLength && blocksSeen >= shortTermBlocks;
+
+    if (addMomentary)
+        momentaryHistogram.add(momentaryEnergy);
+
+    if (addShortTerm)
+        shortTermHistogram.add(shortTermEnergy);
+
+    startQueries(addMomentary, addShortTerm);
+}
+
+void LoudnessMeter::startQueries(bool integrated, bool range)
+{
+    query = {};
+    query.rangePending = range && shortTermHistogram.count > 0;
+
+    // Relative gate: 10 LU below the mean of the absolutely gated blocks
+    if (integrated && momentaryHistogram.count > 0)
+    {
+        query.stage = QueryStage::integrated;
+        query.bin = momentaryHistogram.firstBinAbove(integratedRelativeGateLU);
+    }
+    else if (query.rangePending)
+    {
+        startRangeQuery();
+    }
+}
+
+void LoudnessMeter::startRangeQuery()
+{
+    query.rangePending = false;
+    query.stage = QueryStage::rangeTotal;
+    query.firstBin = query.bin = shortTermHistogram.firstBinAbove(rangeRelativeGateLU);
+    query.count = 0;
+}
+
+void LoudnessMeter::continueQueries(int binBudget)
+{
+    while (query.stage != QueryStage::idle && binBudget > 0)
+    {
+        const int end = binBudget >= numHistogramBins - query.bin ? numHistogramBins : query.bin + binBudget;
+        binBudget -= end - query.bin;
+
+        if (query.stage == QueryStage::integrated)
+        {
+            for (; query.bin < end; ++query.bin)
+            {
+                query.energy += momentaryHistogram.bins[static_cast<size_t>(query.bin)].energy;
+                query.count += momentaryHistogram.bins[static_cast<size_t>(query.bin)].count;
+            }
+
+            if (query.bin < numHistogramBins)
+                continue;
+
+            if (query.count > 0)
+                integratedLUFS.store(energyToLUFS(query.energy / static_cast<double>(query.count)));
+
+            query.stage = QueryStage::idle;
+
+            if (query.rangePending)
+                startRangeQuery();
+        }
+        else if (query.stage == QueryStage::rangeTotal)
+        {
+            for (; query.bin < end; ++query.bin)
+                query.count += shortTermHistogram.bins[static_cast<size_t>(query.bin)].count;
+
+            if (query.bin < numHistogramBins)
+                continue;
+
+            if (query.count == 0)
+            {
+                query.stage = QueryStage::idle;
+                continue;
+            }
+
+            // LRA = 95th minus 10th percentile of the gated short-term distribution
+            const auto total = static_cast<double>(query.count);
+            query.lowRank = static_cast<juce::int64>(std::ceil(0.10 * total));
+            query.highRank = static_cast<juce::int64>(std::ceil(0.95 * total));
+            query.cumulative = 0;
+            query.low = 0.0;
+            query.bin = query.firstBin;
+            query.stage = QueryStage::rangePercentiles;
+        }
+        else
+        {
+            for (; query.bin < end; ++query.bin)
+            {
+                const auto binCount = shortTermHistogram.bins[static_cast<size_t>(query.bin)].count;
+                if (binCount == 0)
+                    continue;
+
+                const double binLoudness = absoluteGateLUFS + (query.bin + 0.5) * histogramStep;
+
+                if (query.cumulative < query.lowRank && query.cumulative + binCount >= query.lowRank)
+                    query.low = binLoudness;
+
+                query.cumulative += binCount;
+
+                if (query.cumulative >= query.highRank)
+                {
+                    loudnessRange.store(static_cast<float>(binLoudness - query.low));
+                    query.stage = QueryStage::idle;
+                    break;
+                }
+            }
+
+            if (query.bin >= numHistogramBins)
+                query.stage = QueryStage::idle;
+        }
+    }
+}
+
+float LoudnessMeter::gateWindows(const std::vector<double>& windowEnergies)
+{
+    const double absoluteGateEnergy = std::pow(10.0, (absoluteGateLUFS + 0.691) / 10.0);
+    double energy = 0.0;
+    int count = 0;
+
+    for (const double window : windowEnergies)
+    {
+        if (window > absoluteGateEnergy)
+        {
+            energy += window;
+            ++count;
+        }
+    }
+
+    if (count == 0)
+        return silenceLUFS;
+
+    const double relativeGateEnergy = energy / count * std::pow(10.0, integratedRelativeGateLU / 10.0);
+    energy = 0.0;
+    count = 0;
+
+    for (const double window : windowEnergies)
+    {
+        if (window > absoluteGateEnergy && window > relativeGateEnergy)
+        {
+            energy += window;
+            ++count;
+        }
+    }
+
+    return count > 0 ? energyToLUFS(energy / count) : silenceLUFS;
+}
+
+float LoudnessMeter::energyToLUFS(double meanSquare)
+{
+    if (meanSquare <= 1e-10)
+        return silenceLUFS;
+
+    return static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare));
+}
@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+    Momentary / short-term / integrated loudness measurement.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "DecibelConversion.h"
+
+//==============================================================================
+// ITU-R BS.1770-4 / EBU R128 loudness: K-weighted, summed over channels,
+// gated integrated loudness, EBU Tech 3342 loudness range and 4x
+// oversampled true peak.
+//
+// Loudness is accumulated in 100 ms gating blocks, so the history is a few
+// numbers per block and its size does not depend on the sample rate. The
+// gates work on fixed 0.01 LU histograms rather than a growing list of
+// blocks. The sample-rate dependent settings live in an immutable Config
+// that is built on the message thread and picked up by the audio thread
+// with an atomic exchange; the audio thread never allocates or frees one.
+class LoudnessMeter
+{
+public:
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    // Message thread. Only a sample-rate change replaces the configuration
+    // and clears the history - a new block size keeps everything running.
+    void prepare(double sampleRate);
+
+    // Audio thread
+    template <typename SampleType>
+    void process(const SampleType* const* channels, int numChannels, int numSamples);
+
+    // Audio thread, before process(): the host timeline position of the
+    // first sample, or -1 when stopped or unknown. While it is known the
+    // 100 ms blocks sit on a grid of the timeline; a jump (seek, loop) ends
+    // the current block early and starts again on the grid.
+    void setTimelinePosition(juce::int64 samplePosition);
+
+    // One finished 100 ms block on the timeline grid
+    struct BlockRecord
+    {
+        juce::int64 timelineBlock;  // timeline sample / samplesPerBlock
+        int samplesPerBlock;
+        bool complete;              // false if cut short or started off the grid
+        double energy;              // K-weighted, summed over channels
+        float truePeak;
+        float fingerprint;          // plain sum of the input samples
+    };
+
+    // Message thread: takes up to maxRecords blocks finished since last time
+    int readBlockRecords(BlockRecord* destination, int maxRecords);
+
+    // Audio thread: the highest true peak (linear) since the last call
+    float takeRecentTruePeak() noexcept
+    {
+        const float peak = recentTruePeak;
+        recentTruePeak = 0.0f;
+        return peak;
+    }
+
+    // Number of times playback started or the timeline jumped
+    int getNumDiscontinuities() const { return discontinuities.load(); }
+
+    float getMomentaryLUFS() const { return momentaryLUFS.load(); }
+    float getShortTermLUFS() const { return shortTermLUFS.load(); }
+    float getIntegratedLUFS() const { return integratedLUFS.load(); }
+    float getLoudnessRange() const { return loudnessRange.load(); }
+
+    // Maximum true peak since the last reset, in dBTP
+    float getTruePeakDecibels() const { return DecibelConversion::gainToDecibels(truePeak.load(), silenceLUFS); }
+
+    // Maximum true peak over the short-term (3 s) window, in dBTP
+    float getShortTermTruePeakDecibels() const { return DecibelConversion::gainToDecibels(shortTermTruePeak.load(), silenceLUFS); }
+
+    static constexpr float silenceLUFS = -70.0f;
+
+    static float energyToLUFS(double meanSquare);
+
+    // Integrated loudness of a list of 400 ms window energies, with the
+    // same absolute and relative gates as the live measurement
+    static float gateWindows(const std::vector<double>& windowEnergies);
+
+private:
+    //==============================================================================
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+    };
+
+    static constexpr int truePeakTapsPerPhase = 16;
+    static constexpr int maxOversampling = 4;
+
+    struct Config
+    {
+        explicit Config(double rate);
+
+        const double sampleRate;
+        const int samplesPerBlock; // 100 ms gating block
+
+        // K-weighting: high-shelf pre-filter, then the RLB high-pass
+        Biquad preFilter, rlbFilter;
+
+        // Polyphase interpolator, phase-major: 4x below 96 kHz, 2x below
+        // 192 kHz, none above
+        int oversampling = 1;
+        std::array<float, truePeakTapsPerPhase * maxOversampling> truePeakCoefficients{};
+    };
+
+    static constexpr int momentaryBlocks = 4;   // 400 ms
+    static constexpr int shortTermBlocks = 30;  // 3 s
+    static constexpr int maxChannels = 2;
+
+    // Gating histograms: 0.01 LU bins from the absolute gate up to +10 LUFS
+    static constexpr double histogramStep = 0.01;
+    static constexpr int numHistogramBins = 8000;
+
+    struct HistogramBin
+    {
+        double energy = 0.0;
+        juce::int64 count = 0;
+    };
+
+    struct GatedHistogram
+    {
+        std::array<HistogramBin, numHistogramBins> bins;
+        double energy = 0.0;      // everything above the absolute gate
+        juce::int64 count = 0;
+
+        void clear();
+        void add(double blockEnergy);
+        int firstBinAbove(double relativeGateLU) const;
+    };
+
+    struct ChannelState
+    {
+        double pre1 = 0.0, pre2 = 0.0, rlb1 = 0.0, rlb2 = 0.0;
+
+        // Last truePeakTapsPerPhase inputs, stored twice so a contiguous
+        // window is always available
+        std::array<float, truePeakTapsPerPhase * 2> truePeakHistory{};
+        int truePeakPos = 0;
+    };
+
+    void adoptPendingConfig();
+    void resetHistory();
+    void finishBlock(bool complete);
+
+    // The integrated gate and the range percentiles scan the histograms.
+    // Rather than all in the callback that finishes a block, the scans are
+    // resumed from process() with a bin budget in proportion to the samples
+    // processed, so the cost per sample stays flat; the values trail the
+    // block by a fraction of its length.
+    enum class QueryStage { idle, integrated, rangeTotal, rangePercentiles };
+
+    struct GateQuery
+    {
+        QueryStage stage = QueryStage::idle;
+        bool rangePending = false;
+        int bin = 0, firstBin = 0;
+        double energy = 0.0, low = 0.0;
+        juce::int64 count = 0, cumulative = 0, lowRank = 0, highRank = 0;
+    };
+
+    void startQueries(bool integrated, bool range);
+    void startRangeQuery();
+    void continueQueries(int binBudget);
+
+    template <typename SampleType>
+    double weightChannel(ChannelState& state, const SampleType* data, int numSamples, double& plainSum) const;
+
+    template <typename SampleType>
+    float findTruePeak(ChannelState& state, const SampleType* data, int numSamples) const;
+
+    // Message thread -> audio thread handoff; the audio thread hands the
+    // config it replaced back through retiredConfig for deletion
+    std::atomic<Config*> pendingConfig{ nullptr };
+    std::atomic<Config*> retiredConfig{ nullptr };
+    Config* activeConfig = nullptr;
+    double preparedSampleRate = 0.0;
+
+    // Audio-thread state
+    std::array<ChannelState, maxChannels> channelStates;
+    double blockSumSquares = 0.0;
+    int blockSampleCount = 0;
+    int blockLength = 0;            // samples in the current block, normally samplesPerBlock
+    float blockTruePeak = 0.0f;
+    float recentTruePeak = 0.0f;    // read back by takeRecentTruePeak()
+    double blockPlainSum = 0.0;
+
+    // Timeline grid
+    juce::int64 timelineBlock = -1;     // block being filled, -1 when free-running
+    juce::int64 expectedPosition = -1;  // where the next process() should start
+    bool blockOnGrid = false;
+
+    static constexpr int recordFifoSize = 512;
+    juce::AbstractFifo recordFifo{ recordFifoSize };
+    std::array<BlockRecord, recordFifoSize> records;
+    std::atomic<int> discontinuities{ 0 };
+
+    // Per block: sum of squares and sample count, so a block cut short by
+    // a seek or stop weighs in proportion to its length. Empty slots count
+    // as silent full blocks, which gives the usual ramp-up at the start.
+    std::array<double, shortTermBlocks> blockSums{};
+    std::array<int, shortTermBlocks> blockCounts{};
+    std::array<float, shortTermBlocks> blockPeaks{};
+    int blockWritePos = 0;
+    juce::int64 blocksSeen = 0;
+    GatedHistogram momentaryHistogram, shortTermHistogram;
+    GateQuery query;
+
+    std::atomic<float> momentaryLUFS{ silenceLUFS };
+    std::atomic<float> shortTermLUFS{ silenceLUFS };
+    std::atomic<float> integratedLUFS{ silenceLUFS };
+    std::atomic<float> loudnessRange{ 0.0f };
+    std::atomic<float> truePeak{ 0.0f };
+    std::atomic<float> shortTermTruePeak{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
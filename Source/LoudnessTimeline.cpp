@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+    Loudness of the whole host timeline, cached per 100 ms block.
+  ==============================================================================
+*/
+
+#include "LoudnessTimeline.h"
+
+//==============================================================================
+LoudnessTimeline::LoudnessTimeline(LoudnessMeter& meterToFollow)
+    : meter(meterToFollow)
+{
+    startTimerHz(10);
+}
+
+LoudnessTimeline::~LoudnessTimeline()
+{
+    stopTimer();
+}
+
+void LoudnessTimeline::clear()
+{
+    blocks.clear();
+    numReused = 0;
+    numReplaced = 0;
+    ++version;
+}
+
+bool LoudnessTimeline::isCached(juce::int64 block) const
+{
+    return juce::isPositiveAndBelow(block, getNumBlocks()) && blocks[static_cast<size_t>(block)].energy >= 0.0;
+}
+
+//==============================================================================
+void LoudnessTimeline::timerCallback()
+{
+    for (;;)
+    {
+        const int numRead = meter.readBlockRecords(incoming.data(), static_cast<int>(incoming.size()));
+
+        for (int i = 0; i < numRead; ++i)
+            store(incoming[static_cast<size_t>(i)]);
+
+        if (numRead < static_cast<int>(incoming.size()))
+            break;
+    }
+}
+
+void LoudnessTimeline::store(const LoudnessMeter::BlockRecord& record)
+{
+    // Block indices only mean something at one sample rate
+    if (record.samplesPerBlock != samplesPerBlock)
+    {
+        clear();
+        samplesPerBlock = record.samplesPerBlock;
+    }
+
+    playPositionBlock = record.timelineBlock + 1;
+
+    // Blocks cut short by a seek or a loop don't describe a whole 100 ms
+    if (! record.complete || record.timelineBlock >= maxBlocks)
+        return;
+
+    const auto index = static_cast<size_t>(record.timelineBlock);
+
+    if (index >= blocks.size())
+        blocks.resize(index + 1);
+
+    auto& block = blocks[index];
+
+    if (block.energy >= 0.0)
+    {
+        if (matches(block, record))
+        {
+            ++numReused;
+            return;
+        }
+
+        ++numReplaced;
+    }
+
+    block = { record.energy, record.truePeak, record.fingerprint };
+    ++version;
+}
+
+bool LoudnessTimeline::matches(const Block& block, const LoudnessMeter::BlockRecord& record)
+{
+    // Same audio gives the same block up to filter state carried over the
+    // seek: allow 0.05 dB of energy and a little rounding in the sum
+    const double energyRatio = (record.energy + 1e-12) / (block.energy + 1e-12);
+
+    return energyRatio > 0.9886 && energyRatio < 1.0116
+        && std::abs(record.fingerprint - block.fingerprint) <= 1e-3f + 1e-4f * std::abs(block.fingerprint);
+}
+
+//==============================================================================
+float LoudnessTimeline::getMomentaryLUFS(juce::int64 block) const
+{
+    double energy = 0.0;
+
+    for (juce::int64 i = block - 3; i <= block; ++i)
+    {
+        if (! isCached(i))
+            return LoudnessMeter::silenceLUFS;
+
+        energy += blocks[static_cast<size_t>(i)].energy;
+    }
+
+    return LoudnessMeter::energyToLUFS(energy / 4.0);
+}
+
+LoudnessTimeline::RangeMeasurement LoudnessTimeline::measureRange(juce::int64 firstBlock, juce::int64 endBlock) const
+{
+    RangeMeasurement result;
+
+    firstBlock = juce::jmax(firstBlock, juce::int64(0));
+    endBlock = juce::jmin(endBlock, getNumBlocks());
+    if (endBlock <= firstBlock)
+        return result;
+
+    // 400 ms windows stepped by 100 ms that lie inside the range and are
+    // fully cached
+    std::vector<double> windows;
+    windows.reserve(static_cast<size_t>(endBlock - firstBlock));
+
+    float truePeak = 0.0f;
+    juce::int64 numCached = 0;
+    int run = 0;
+    double runEnergy[4] = {};
+
+    for (juce::int64 i = firstBlock; i < endBlock; ++i)
+    {
+        const auto& block = blocks[static_cast<size_t>(i)];
+
+        if (block.energy < 0.0)
+        {
+            run = 0;
+            continue;
+        }
+
+        ++numCached;
+        truePeak = juce::jmax(truePeak, block.truePeak);
+        runEnergy[run % 4] = block.energy;
+
+        if (++run >= 4)
+            windows.push_back((runEnergy[0] + runEnergy[1] + runEnergy[2] + runEnergy[3]) / 4.0);
+    }
+
+    result.integratedLUFS = LoudnessMeter::gateWindows(windows);
+    result.truePeakDecibels = DecibelConversion::gainToDecibels(truePeak, LoudnessMeter::silenceLUFS);
+    result.coverage = static_cast<float>(numCached) / static_cast<float>(endBlock - firstBlock);
+    return result;
+}
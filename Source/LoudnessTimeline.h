@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+    Loudness of the whole host timeline, cached per 100 ms block.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+
+//==============================================================================
+// Collects the timeline-aligned blocks the loudness meter finishes during
+// playback and keeps one entry per 100 ms of the song. Playing a passage
+// again only confirms what is cached: each entry carries a fingerprint (its
+// energy and the plain sum of its samples), and a block that no longer
+// matches - the mix changed - replaces the old one. Any range that has been
+// heard once can then be measured at once, without playing it again.
+//
+// Everything here runs on the message thread; the meter hands blocks over
+// through a lock-free FIFO that a timer drains.
+class LoudnessTimeline : private juce::Timer
+{
+public:
+    explicit LoudnessTimeline(LoudnessMeter& meterToFollow);
+    ~LoudnessTimeline() override;
+
+    void clear();
+
+    // Blocks from the start of the timeline to the last one cached
+    juce::int64 getNumBlocks() const { return static_cast<juce::int64>(blocks.size()); }
+    int getSamplesPerBlock() const { return samplesPerBlock; }
+    bool isCached(juce::int64 block) const;
+
+    // 400 ms loudness ending with this block (silence if not all cached)
+    float getMomentaryLUFS(juce::int64 block) const;
+
+    struct RangeMeasurement
+    {
+        float integratedLUFS = LoudnessMeter::silenceLUFS;
+        float truePeakDecibels = LoudnessMeter::silenceLUFS;
+        float coverage = 0.0f;      // fraction of the range that is cached
+    };
+
+    // Blocks [firstBlock, endBlock), gated like the live integrated value
+    RangeMeasurement measureRange(juce::int64 firstBlock, juce::int64 endBlock) const;
+
+    // Where playback was last heard, in blocks (-1 before any)
+    juce::int64 getPlayPositionBlock() const { return playPositionBlock; }
+
+    // Blocks confirmed by replaying them, and blocks that had changed
+    int getNumReused() const { return numReused; }
+    int getNumReplaced() const { return numReplaced; }
+    int getNumSeeks() const { return meter.getNumDiscontinuities(); }
+
+    // Changes whenever a block is cached, replaced or cleared, so views can
+    // keep what they derived from the blocks until then
+    juce::uint32 getVersion() const { return version; }
+
+    // Six hours at 100 ms per block
+    static constexpr juce::int64 maxBlocks = 6 * 60 * 60 * 10;
+
+private:
+    struct Block
+    {
+        double energy = -1.0;       // negative: not cached
+        float truePeak = 0.0f;
+        float fingerprint = 0.0f;
+    };
+
+    void timerCallback() override;
+    void store(const LoudnessMeter::BlockRecord& record);
+    static bool matches(const Block& block, const LoudnessMeter::BlockRecord& record);
+
+    LoudnessMeter& meter;
+    std::vector<Block> blocks;
+    std::array<LoudnessMeter::BlockRecord, 64> incoming;
+    int samplesPerBlock = 0;
+    juce::int64 playPositionBlock = -1;
+    int numReused = 0, numReplaced = 0;
+    juce::uint32 version = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessTimeline)
+};
@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+    Numeric readouts and level bars that redraw only what changed.
+  ==============================================================================
+*/
+
+#include "MeterComponents.h"
+#include "DecibelConversion.h"
+#include <cstring>
+
+namespace
+{
+    constexpr float textHeight = 12.0f;
+
+    float getTextWidth(const juce::String& text)
+    {
+        return juce::GlyphArrangement::getStringWidth(juce::Font(juce::FontOptions(textHeight)), text);
+    }
+
+    // A transparent layer at twice the component's size, drawn once
+    template <typename Drawer>
+    juce::Image renderLayer(int width, int height, Drawer&& draw)
+    {
+        juce::Image layer(juce::Image::ARGB, juce::jmax(1, width * 2), juce::jmax(1, height * 2), true);
+        juce::Graphics g(layer);
+        g.addTransform(juce::AffineTransform::scale(2.0f));
+        g.setFont(juce::FontOptions(textHeight));
+        draw(g);
+        return layer;
+    }
+}
+
+//==============================================================================
+MeterGlyphAtlas::MeterGlyphAtlas(float fontHeight)
+{
+    const juce::Font font(juce::FontOptions(fontHeight * scale));
+    const int numGlyphs = static_cast<int>(std::strlen(glyphs));
+    float widest = 0.0f;
+
+    for (int i = 0; i < numGlyphs; ++i)
+        widest = juce::jmax(widest, juce::GlyphArrangement::getStringWidth(font, juce::String::charToString(glyphs[i])));
+
+    advance = static_cast<int>(std::ceil(widest / scale));
+    height = static_cast<int>(std::ceil(fontHeight)) + 2;
+
+    image = juce::Image(juce::Image::SingleChannel, numGlyphs * advance * scale, height * scale, true);
+    juce::Graphics g(image);
+    g.setColour(juce::Colours::white);
+    g.setFont(font);
+
+    for (int i = 0; i < numGlyphs; ++i)
+        g.drawText(juce::String::charToString(glyphs[i]), i * advance * scale, 0, advance * scale, height * scale,
+            juce::Justification::centred, false);
+}
+
+void MeterGlyphAtlas::draw(juce::Graphics& g, const char* text, juce::Rectangle<int> area) const
+{
+    int x = area.getRight() - static_cast<int>(std::strlen(text)) * advance;
+    const int y = area.getCentreY() - height / 2;
+
+    for (const char* c = text; *c != 0; ++c, x += advance)
+    {
+        if (const char* glyph = std::strchr(glyphs, *c); glyph != nullptr)
+        {
+            const int index = static_cast<int>(glyph - glyphs);
+            g.drawImage(image, x, y, advance, height, index * advance * scale, 0, advance * scale, height * scale, true);
+        }
+    }
+}
+
+int MeterGlyphAtlas::formatNumber(char* buffer, float value, int decimals, float floorValue)
+{
+    // Also catches NaN
+    if (! (value > floorValue))
+    {
+        std::memcpy(buffer, "-inf", 5);
+        return 4;
+    }
+
+    static constexpr double powersOfTen[] = { 1.0, 10.0, 100.0, 1000.0 };
+    decimals = juce::jlimit(0, 3, decimals);
+
+    auto scaled = static_cast<juce::int64>(std::llround(std::abs(static_cast<double>(value)) * powersOfTen[decimals]));
+    scaled = juce::jmin(scaled, juce::int64(9999999));
+
+    // Digits come out least significant first
+    char digits[maxTextLength];
+    int numDigits = 0;
+    const bool negative = value < 0.0f && scaled > 0;
+
+    do
+    {
+        digits[numDigits++] = static_cast<char>('0' + scaled % 10);
+        scaled /= 10;
+    }
+    while (scaled > 0 || numDigits <= decimals);
+
+    int length = 0;
+
+    if (negative)
+        buffer[length++] = '-';
+
+    for (int i = numDigits - 1; i >= 0; --i)
+    {
+        buffer[length++] = digits[i];
+
+        if (i == decimals && decimals > 0)
+            buffer[length++] = '.';
+    }
+
+    buffer[length] = 0;
+    return length;
+}
+
+//==============================================================================
+float MeterBallistics::process(float gain, float seconds)
+{
+    seconds = juce::jlimit(0.0f, 0.5f, seconds);
+
+    if (mode == Mode::peakProgramme)
+    {
+        constexpr float fallRate = 20.0f / 1.5f;   // dB per second
+        constexpr float holdTime = 1.5f;
+
+        level = juce::jmax(DecibelConversion::gainToDecibels(gain, floordB), level - fallRate * seconds);
+        holdSeconds += seconds;
+
+        if (level >= holddB || holdSeconds > holdTime)
+        {
+            holddB = level;
+            holdSeconds = 0.0f;
+        }
+
+        return level;
+    }
+
+    // 99% of a step in 300 ms: time constant 0.3 / ln(100)
+    constexpr float timeConstant = 0.0651f;
+    level += (1.0f - std::exp(-seconds / timeConstant)) * (gain - level);
+    return DecibelConversion::gainToDecibels(level, floordB);
+}
+
+//==============================================================================
+NumericReadout::NumericReadout(const MeterGlyphAtlas& glyphAtlas, std::initializer_list<FieldSpec> specs)
+    : atlas(glyphAtlas)
+{
+    for (const auto& spec : specs)
+    {
+        Field field;
+        field.spec = spec;
+        fields.push_back(field);
+    }
+}
+
+void NumericReadout::setValue(int index, float value)
+{
+    auto& field = fields[static_cast<size_t>(index)];
+    char text[MeterGlyphAtlas::maxTextLength];
+    MeterGlyphAtlas::formatNumber(text, value, field.spec.decimals);
+
+    if (std::strcmp(text, field.text) != 0)
+    {
+        std::strcpy(field.text, text);
+        repaint(field.slot);
+    }
+}
+
+void NumericReadout::setValueColour(int index, juce::Colour colour)
+{
+    auto& field = fields[static_cast<size_t>(index)];
+
+    if (colour != field.colour)
+    {
+        field.colour = colour;
+        repaint(field.slot);
+    }
+}
+
+void NumericReadout::paint(juce::Graphics& g)
+{
+    g.drawImage(staticLayer, 0, 0, getWidth(), getHeight(), 0, 0, staticLayer.getWidth(), staticLayer.getHeight());
+
+    for (const auto& field : fields)
+    {
+        g.setColour(field.colour);
+        atlas.draw(g, field.text, field.slot);
+    }
+}
+
+void NumericReadout::resized()
+{
+    constexpr float gap = 5.0f, fieldGap = 24.0f;
+    float totalWidth = fieldGap * static_cast<float>(fields.size() - 1);
+
+    for (auto& field : fields)
+    {
+        field.captionWidth = getTextWidth(field.spec.caption + ":");
+        field.unitWidth = field.spec.unit.isEmpty() ? 0.0f : gap + getTextWidth(field.spec.unit);
+        totalWidth += field.captionWidth + gap + static_cast<float>(field.spec.numChars * atlas.getAdvance()) + field.unitWidth;
+    }
+
+    // Centred, like the labels this replaces
+    const float height = static_cast<float>(getHeight());
+    float x = (static_cast<float>(getWidth()) - totalWidth) / 2.0f;
+
+    staticLayer = renderLayer(getWidth(), getHeight(), [&](juce::Graphics& g)
+    {
+        g.setColour(juce::Colours::white);
+
+        for (auto& field : fields)
+        {
+            g.drawText(field.spec.caption + ":", juce::Rectangle<float>(x, 0.0f, field.captionWidth, height),
+                juce::Justification::centredLeft, false);
+            x += field.captionWidth + gap;
+
+            const int slotWidth = field.spec.numChars * atlas.getAdvance();
+            field.slot = { juce::roundToInt(x), 0, slotWidth, getHeight() };
+            x += static_cast<float>(slotWidth);
+
+            if (field.unitWidth > 0.0f)
+                g.drawText(field.spec.unit, juce::Rectangle<float>(x + gap, 0.0f, field.unitWidth - gap, height),
+                    juce::Justification::centredLeft, false);
+
+            x += field.unitWidth + fieldGap;
+        }
+    });
+}
+
+//==============================================================================
+LevelMeter::LevelMeter(const MeterGlyphAtlas& glyphAtlas, const juce::String& captionText, MeterBallistics::Mode mode)
+    : atlas(glyphAtlas), caption(captionText), ballistics(mode)
+{
+}
+
+void LevelMeter::setLevel(float gain, float seconds)
+{
+    const float decibels = ballistics.process(gain, seconds);
+
+    char newText[MeterGlyphAtlas::maxTextLength];
+    MeterGlyphAtlas::formatNumber(newText, decibels, 1, MeterBallistics::floordB);
+
+    if (std::strcmp(newText, text) != 0)
+    {
+        std::strcpy(text, newText);
+        repaint(valueArea);
+    }
+
+    const int newBarPixels = decibelsToPixels(decibels);
+    const int newHoldPixels = decibelsToPixels(ballistics.getHolddB());
+
+    if (newBarPixels != barPixels || newHoldPixels != holdPixels)
+    {
+        barPixels = newBarPixels;
+        holdPixels = newHoldPixels;
+        repaint(barArea);
+    }
+}
+
+int LevelMeter::decibelsToPixels(float decibels) const
+{
+    return juce::jlimit(0, barArea.getWidth(),
+        juce::roundToInt((decibels + rangedB) / rangedB * static_cast<float>(barArea.getWidth())));
+}
+
+void LevelMeter::paint(juce::Graphics& g)
+{
+    g.drawImage(captionLayer, 0, 0, getWidth(), getHeight(), 0, 0, captionLayer.getWidth(), captionLayer.getHeight());
+
+    g.setColour(juce::Colour(0xff1a1a1a));
+    g.fillRect(barArea);
+
+    // Orange in the top 6 dB
+    const int orangeFrom = decibelsToPixels(-6.0f);
+    g.setColour(juce::Colour(0xff66cc66));
+    g.fillRect(barArea.withWidth(juce::jmin(barPixels, orangeFrom)));
+
+    if (barPixels > orangeFrom)
+    {
+        g.setColour(juce::Colour(0xffff9933));
+        g.fillRect(barArea.withTrimmedLeft(orangeFrom).withWidth(barPixels - orangeFrom));
+    }
+
+    if (holdPixels > 0)
+    {
+        g.setColour(juce::Colours::white);
+        g.fillRect(barArea.getX() + holdPixels - 1, barArea.getY(), 1, barArea.getHeight());
+    }
+
+    g.setColour(juce::Colours::white);
+    atlas.draw(g, text, valueArea);
+}
+
+void LevelMeter::resized()
+{
+    auto bounds = getLocalBounds();
+    captionArea = bounds.removeFromLeft(juce::roundToInt(getTextWidth(caption)) + 8);
+    valueArea = bounds.removeFromRight(5 * atlas.getAdvance());
+    barArea = bounds.reduced(4, 0).withSizeKeepingCentre(bounds.getWidth() - 8, 10);
+
+    captionLayer = renderLayer(getWidth(), getHeight(), [&](juce::Graphics& g)
+    {
+        g.setColour(juce::Colours::white);
+        g.drawText(caption, captionArea, juce::Justification::centredLeft, false);
+    });
+
+    // Redraw the bar at the new size
+    barPixels = holdPixels = -1;
+}
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+    Numeric readouts and level bars that redraw only what changed.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// The characters a readout needs ("0-9 . - + inf"), rendered once at twice
+// the display size into a single-channel image. All digits share the widest
+// digit's advance, so numbers don't shift as they change; drawing a number
+// is one image blit per character in the current colour.
+class MeterGlyphAtlas
+{
+public:
+    explicit MeterGlyphAtlas(float fontHeight);
+
+    int getAdvance() const { return advance; }
+    int getHeight() const { return height; }
+
+    // Right-aligned in area, vertically centred
+    void draw(juce::Graphics& g, const char* text, juce::Rectangle<int> area) const;
+
+    // Writes value with a fixed number of decimals into a buffer of at least
+    // maxTextLength bytes, "-inf" at or below floorValue. Returns the length.
+    static constexpr int maxTextLength = 12;
+    static int formatNumber(char* buffer, float value, int decimals, float floorValue = -1.0e9f);
+
+private:
+    static constexpr const char* glyphs = "0123456789.-+inf";
+    static constexpr int scale = 2;
+
+    juce::Image image;
+    int advance = 0, height = 0;
+};
+
+//==============================================================================
+// Needle behaviour of the classic meters, on values sampled at the editor's
+// frame rate. Peak programme: instant rise, falls 20 dB in 1.5 s (IEC 60268-10
+// type I), with a 1.5 s peak hold. Volume unit: a one-pole average of the
+// level that covers 99% of a step in 300 ms.
+class MeterBallistics
+{
+public:
+    enum class Mode
+    {
+        peakProgramme,
+        volumeUnit
+    };
+
+    explicit MeterBallistics(Mode m) : mode(m), level(m == Mode::peakProgramme ? floordB : 0.0f) {}
+
+    // Linear gain in, dB out; 'seconds' since the previous call
+    float process(float gain, float seconds);
+
+    float getHolddB() const { return holddB; }
+
+    static constexpr float floordB = -100.0f;
+
+private:
+    const Mode mode;
+    float level;                // dB for peak programme, gain for volume unit
+    float holddB = floordB;
+    float holdSeconds = 0.0f;
+};
+
+//==============================================================================
+// A row of "Caption: value unit" fields, centred. The captions and units are
+// rendered once per size into a cached layer and the values come from the
+// glyph atlas. Setting a value formats it into a fixed buffer; only when the
+// text or colour differs from what is on screen is the field's value slot
+// invalidated.
+class NumericReadout : public juce::Component
+{
+public:
+    struct FieldSpec
+    {
+        juce::String caption;
+        juce::String unit;
+        int decimals = 1;
+        int numChars = 5;       // value slot width, in digits
+    };
+
+    NumericReadout(const MeterGlyphAtlas& glyphAtlas, std::initializer_list<FieldSpec> specs);
+
+    void setValue(int field, float value);
+    void setValueColour(int field, juce::Colour colour);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    struct Field
+    {
+        FieldSpec spec;
+        float captionWidth = 0.0f, unitWidth = 0.0f;
+        juce::Colour colour = juce::Colours::white;
+        char text[MeterGlyphAtlas::maxTextLength] = "";
+        juce::Rectangle<int> slot;
+    };
+
+    const MeterGlyphAtlas& atlas;
+    std::vector<Field> fields;
+    juce::Image staticLayer;
+};
+
+//==============================================================================
+// Caption, horizontal bar (-60..0 dBFS) and dB readout for one level, with
+// peak-programme or VU ballistics applied at the editor's frame rate. The
+// bar invalidates itself only when its length or hold marker moves by a
+// whole pixel, the readout only when its text changes.
+class LevelMeter : public juce::Component
+{
+public:
+    LevelMeter(const MeterGlyphAtlas& glyphAtlas, const juce::String& caption, MeterBallistics::Mode mode);
+
+    // Message thread, once per frame
+    void setLevel(float gain, float seconds);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    int decibelsToPixels(float decibels) const;
+
+    const MeterGlyphAtlas& atlas;
+    const juce::String caption;
+    MeterBallistics ballistics;
+
+    juce::Rectangle<int> captionArea, barArea, valueArea;
+    juce::Image captionLayer;
+    int barPixels = 0, holdPixels = -1;
+    char text[MeterGlyphAtlas::maxTextLength] = "";
+
+    static constexpr float rangedB = 60.0f;
+};
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+    Timestamped metering events: clips, overs, silences, DC offset and
+    loudness excursions.
+  ==============================================================================
+*/
+
+#include "MeterEvents.h"
+
+//==============================================================================
+const char* MeterEvent::getName(Type type)
+{
+    switch (type)
+    {
+        case Type::clip:            return "Clip";
+        case Type::truePeakOver:    return "True-peak over";
+        case Type::silence:         return "Silence";
+        case Type::dcOffset:        return "DC offset";
+        case Type::aboveTarget:     return "Above target";
+        case Type::belowTarget:     return "Below target";
+    }
+
+    return "";
+}
+
+juce::String MeterEvent::describeValue() const
+{
+    switch (type)
+    {
+        case Type::clip:            return juce::String(juce::roundToInt(value)) + " samples";
+        case Type::truePeakOver:    return juce::String(value, 1) + " dBTP";
+        case Type::silence:         return juce::String(value, 1) + " s";
+        case Type::dcOffset:        return juce::String(value, 1) + " dBFS";
+        case Type::aboveTarget:
+        case Type::belowTarget:     return juce::String(value, 1) + " LUFS";
+    }
+
+    return {};
+}
+
+//==============================================================================
+MeterEventQueue::MeterEventQueue()
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+        slots[i].sequence.store(static_cast<juce::uint32>(i), std::memory_order_relaxed);
+}
+
+bool MeterEventQueue::push(const MeterEvent& event) noexcept
+{
+    auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto& slot = slots[position & (capacity - 1)];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<juce::int32>(sequence - position);
+
+        if (difference == 0)
+        {
+            // Free slot: claim the position, then fill it
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The consumer hasn't taken this slot yet: full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // Another producer got here first
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool MeterEventQueue::pop(MeterEvent& event) noexcept
+{
+    auto& slot = slots[dequeuePosition & (capacity - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+        return false;
+
+    event = slot.event;
+    slot.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+    ++dequeuePosition;
+    return true;
+}
+
+//==============================================================================
+void MeterEventDetector::prepare(double sampleRate)
+{
+    requestedSampleRate.store(juce::roundToInt(sampleRate));
+}
+
+void MeterEventDetector::reset()
+{
+    clipRun = {};
+    overRun = {};
+    silenceRun = {};
+    dcSums.fill(0.0);
+    dcSamples = 0;
+    dcWindowStart = -1;
+    dcActive = false;
+}
+
+void MeterEventDetector::addSubBlock(juce::int64 timelineSample, int numSamples, float samplePeak, int numClipped,
+                                     const double* channelSums, int numChannels, float truePeak)
+{
+    if (const int requested = requestedSampleRate.load(std::memory_order_relaxed); requested != samplesPerSecond)
+    {
+        samplesPerSecond = requested;
+        reset();
+    }
+
+    if (samplesPerSecond == 0)
+        return;
+
+    // Extends the run while the condition holds; true once the run ends,
+    // which sends its event
+    auto track = [&](Run& run, bool condition)
+    {
+        if (condition)
+        {
+            if (! run.active)
+                run = { true, timelineSample, 0, 0.0f };
+
+            run.length += numSamples;
+            return false;
+        }
+
+        const bool ended = run.active;
+        run.active = false;
+        return ended;
+    };
+
+    if (track(clipRun, numClipped > 0))
+        queue.push({ MeterEvent::Type::clip, clipRun.start, clipRun.value });
+
+    if (track(overRun, truePeak > truePeakLimit))
+        queue.push({ MeterEvent::Type::truePeakOver, overRun.start, juce::Decibels::gainToDecibels(overRun.value) });
+
+    if (track(silenceRun, samplePeak < silenceThreshold)
+        && silenceRun.length >= static_cast<juce::int64>(minSilenceSeconds * samplesPerSecond))
+        queue.push({ MeterEvent::Type::silence, silenceRun.start,
+                     static_cast<float>(silenceRun.length) / static_cast<float>(samplesPerSecond) });
+
+    clipRun.value += static_cast<float>(numClipped);
+    overRun.value = juce::jmax(overRun.value, truePeak);
+
+    // DC offset: the mean of each channel over 3 s windows. Bass leaves a
+    // residue of at most 1 / (pi f T) of its amplitude, so even full-scale
+    // content stays under the threshold down to about 11 Hz.
+    numChannels = juce::jmin(numChannels, maxChannels);
+
+    if (dcSamples == 0)
+        dcWindowStart = timelineSample;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        dcSums[static_cast<size_t>(channel)] += channelSums[channel];
+
+    dcSamples += numSamples;
+
+    if (dcSamples >= dcWindowSeconds * samplesPerSecond)
+    {
+        double offset = 0.0;
+        for (int channel = 0; channel < numChannels; ++channel)
+            offset = juce::jmax(offset, std::abs(dcSums[static_cast<size_t>(channel)]) / dcSamples);
+
+        const bool hasOffset = offset > dcThreshold;
+
+        if (hasOffset && ! dcActive)
+            queue.push({ MeterEvent::Type::dcOffset, dcWindowStart,
+                         juce::Decibels::gainToDecibels(static_cast<float>(offset)) });
+
+        dcActive = hasOffset;
+        dcSums.fill(0.0);
+        dcSamples = 0;
+    }
+}
+
+void MeterEventDetector::checkLoudness(float shortTermLUFS, juce::int64 timelineSample, float target, float tolerance)
+{
+    // Silence is reported on its own, not as a quiet passage
+    auto state = LoudnessState::withinTarget;
+
+    if (shortTermLUFS > target + tolerance)
+        state = LoudnessState::aboveTarget;
+    else if (shortTermLUFS < target - tolerance && shortTermLUFS > silenceThresholddB)
+        state = LoudnessState::belowTarget;
+
+    if (state != loudnessState && state != LoudnessState::withinTarget)
+        queue.push({ state == LoudnessState::aboveTarget ? MeterEvent::Type::aboveTarget : MeterEvent::Type::belowTarget,
+                     timelineSample, shortTermLUFS });
+
+    loudnessState = state;
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+    Timestamped metering events: clips, overs, silences, DC offset and
+    loudness excursions.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+struct MeterEvent
+{
+    enum class Type : juce::uint8
+    {
+        clip,           // value: samples at or above full scale
+        truePeakOver,   // value: highest true peak, dBTP
+        silence,        // value: length in seconds
+        dcOffset,       // value: offset, dBFS
+        aboveTarget,    // value: short-term loudness, LUFS
+        belowTarget     // value: short-term loudness, LUFS
+    };
+
+    Type type = Type::clip;
+    juce::int64 timelineSample = -1;    // where it started; -1 when stopped
+    float value = 0.0f;
+
+    static const char* getName(Type type);
+    juce::String describeValue() const;
+};
+
+//==============================================================================
+// Bounded multi-producer, single-consumer queue (each slot carries a
+// sequence number, so producers only contend on claiming a position). The
+// audio thread and the analysis worker push, the editor pops. A full queue
+// drops the event and counts it; pushing never allocates, locks or waits.
+class MeterEventQueue
+{
+public:
+    static constexpr int capacity = 256;
+
+    MeterEventQueue();
+
+    // Any thread; false if the event was dropped
+    bool push(const MeterEvent& event) noexcept;
+
+    // Single consumer (message thread)
+    bool pop(MeterEvent& event) noexcept;
+
+    int getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    struct Slot
+    {
+        std::atomic<juce::uint32> sequence{ 0 };
+        MeterEvent event;
+    };
+
+    std::array<Slot, capacity> slots;
+    std::atomic<juce::uint32> enqueuePosition{ 0 };
+    juce::uint32 dequeuePosition = 0;
+    std::atomic<int> dropped{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(MeterEventQueue)
+};
+
+//==============================================================================
+// Turns the levels the processor already gathers into events. The audio
+// thread hands over one summary per sub-block (the only per-sample work is
+// a running sum and a clip count in the existing energy pass); the analysis
+// worker checks short-term loudness against the target each frame. Clips,
+// overs and silences are reported once per run, when the run ends; DC offset
+// and loudness excursions when they start.
+class MeterEventDetector
+{
+public:
+    // Message thread
+    void prepare(double sampleRate);
+
+    // Audio thread. channelSums holds the plain sum of each channel,
+    // truePeak is linear.
+    void addSubBlock(juce::int64 timelineSample, int numSamples, float samplePeak, int numClipped,
+                     const double* channelSums, int numChannels, float truePeak);
+
+    // Analysis worker, with the target from its settings snapshot
+    void checkLoudness(float shortTermLUFS, juce::int64 timelineSample, float target, float tolerance);
+
+    // Message thread
+    bool popEvent(MeterEvent& event) noexcept { return queue.pop(event); }
+    int getNumDropped() const noexcept { return queue.getNumDropped(); }
+
+    // Overs are above -1 dBTP, silence is a sample peak under -70 dBFS
+    // for 2 s, a DC offset is a mean beyond -40 dBFS
+    static constexpr float truePeakLimit = 0.891251f;
+    static constexpr float silenceThreshold = 3.16228e-4f;
+    static constexpr float silenceThresholddB = -70.0f;
+    static constexpr double minSilenceSeconds = 2.0;
+    static constexpr double dcThreshold = 0.01;
+    static constexpr int dcWindowSeconds = 3;
+
+private:
+    static constexpr int maxChannels = 2;
+
+    enum class LoudnessState
+    {
+        withinTarget,
+        aboveTarget,
+        belowTarget
+    };
+
+    // One run of consecutive sub-blocks that meet a condition
+    struct Run
+    {
+        bool active = false;
+        juce::int64 start = -1;
+        juce::int64 length = 0;
+        float value = 0.0f;         // sum (clips) or maximum (overs)
+    };
+
+    void reset();
+
+    MeterEventQueue queue;
+
+    std::atomic<int> requestedSampleRate{ 0 };
+    int samplesPerSecond = 0;
+
+    // Audio-thread state
+    Run clipRun, overRun, silenceRun;
+    std::array<double, maxChannels> dcSums{};
+    int dcSamples = 0;
+    juce::int64 dcWindowStart = -1;
+    bool dcActive = false;
+
+    // Analysis-worker state
+    LoudnessState loudnessState = LoudnessState::withinTarget;
+};
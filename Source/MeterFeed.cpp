@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+    Publishes this instance's meter values to the shared-memory meter feed.
+  ==============================================================================
+*/
+
+#include "MeterFeed.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #define TRACKTWEAK_METER_FEED 1
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#else
+ #define TRACKTWEAK_METER_FEED 0
+#endif
+
+//==============================================================================
+MeterFeed::MeterFeed()
+{
+    setName("TrackTweak");
+    open();
+}
+
+MeterFeed::~MeterFeed()
+{
+    close();
+}
+
+void MeterFeed::setName(const juce::String& newName)
+{
+    const juce::SpinLock::ScopedLockType lock(nameLock);
+    newName.copyToUTF8(pendingName, sizeof(pendingName));
+    nameChanged = true;
+}
+
+//==============================================================================
+void MeterFeed::open()
+{
+   #if TRACKTWEAK_METER_FEED
+    using namespace MeterFeedLayout;
+
+    const int fd = shm_open(segmentName, O_CREAT | O_RDWR, 0666);
+    if (fd < 0)
+        return;
+
+    // Whoever gets here first sizes the segment; ftruncate zero-fills it
+    struct stat info {};
+    if (fstat(fd, &info) != 0
+        || (info.st_size < static_cast<off_t>(sizeof(Segment)) && ftruncate(fd, sizeof(Segment)) != 0))
+    {
+        ::close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapped == MAP_FAILED)
+        return;
+
+    segment = static_cast<Segment*>(mapped);
+    auto& header = segment->header;
+
+    // Concurrent initialisers write identical values, so the race is benign
+    if (header.magic.load(std::memory_order_acquire) != magic)
+    {
+        header.version = version;
+        header.numSlots = numSlots;
+        header.slotSize = sizeof(Slot);
+        header.magic.store(magic, std::memory_order_release);
+    }
+
+    if (header.version != version || header.slotSize != sizeof(Slot))
+    {
+        close();
+        return;
+    }
+
+    // Take a free slot, or one whose owner process has gone away
+    const auto pid = static_cast<std::uint32_t>(getpid());
+
+    for (auto& candidate : segment->slots)
+    {
+        auto owner = candidate.ownerPid.load(std::memory_order_relaxed);
+        const bool stale = owner != 0 && kill(static_cast<pid_t>(owner), 0) != 0 && errno == ESRCH;
+
+        if ((owner == 0 || stale)
+            && candidate.ownerPid.compare_exchange_strong(owner, pid, std::memory_order_acq_rel))
+        {
+            // A writer that died mid-update leaves an odd sequence behind
+            const auto sequence = candidate.sequence.load(std::memory_order_relaxed);
+            candidate.sequence.store((sequence + 1) & ~1u, std::memory_order_release);
+
+            slot = &candidate;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+        close();
+   #endif
+}
+
+void MeterFeed::close()
+{
+   #if TRACKTWEAK_METER_FEED
+    if (slot != nullptr)
+        slot->ownerPid.store(0, std::memory_order_release);
+
+    if (segment != nullptr)
+        munmap(segment, sizeof(MeterFeedLayout::Segment));
+   #endif
+
+    slot = nullptr;
+    segment = nullptr;
+}
+
+//==============================================================================
+void MeterFeed::publish(const Values& values, const float* spectrumDecibels, int numColumns)
+{
+    if (slot == nullptr)
+        return;
+
+    {
+        const juce::SpinLock::ScopedTryLockType lock(nameLock);
+
+        if (lock.isLocked() && nameChanged)
+        {
+            std::memcpy(payload.name, pendingName, sizeof(payload.name));
+            nameChanged = false;
+        }
+    }
+
+    ++payload.frameCounter;
+    payload.momentaryLUFS = values.momentaryLUFS;
+    payload.shortTermLUFS = values.shortTermLUFS;
+    payload.integratedLUFS = values.integratedLUFS;
+    payload.peak = values.peak;
+    payload.rms = values.rms;
+
+    // Display columns are already log-spaced, so equal groups stay log-spaced
+    constexpr int numBands = MeterFeedLayout::numSpectrumBands;
+    jassert(numColumns >= numBands);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const int start = band * numColumns / numBands;
+        const int end = juce::jmax(start + 1, (band + 1) * numColumns / numBands);
+        payload.spectrum[band] = juce::FloatVectorOperations::findMaximum(spectrumDecibels + start, end - start);
+    }
+
+    MeterFeedLayout::writeSlot(*slot, payload);
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+    Publishes this instance's meter values to the shared-memory meter feed.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "MeterFeedLayout.h"
+
+//==============================================================================
+// Claims one slot of the machine-wide POSIX shared-memory segment and
+// seqlock-writes the latest meter values into it. Opening and closing the
+// segment happen on the message thread; publish() is a memcpy between two
+// atomic stores, so it is safe on the analysis worker at frame rate. On
+// platforms without POSIX shared memory the feed stays disconnected.
+class MeterFeed
+{
+public:
+    struct Values
+    {
+        float momentaryLUFS;
+        float shortTermLUFS;
+        float integratedLUFS;
+        float peak;
+        float rms;
+    };
+
+    MeterFeed();
+    ~MeterFeed();
+
+    bool isConnected() const { return slot != nullptr; }
+
+    // Message thread: shown by readers next to the values
+    void setName(const juce::String& newName);
+
+    // Analysis worker. The spectrum is folded down to the feed's band count
+    // by taking the max of each group of display columns.
+    void publish(const Values& values, const float* spectrumDecibels, int numColumns);
+
+private:
+    void open();
+    void close();
+
+    MeterFeedLayout::Segment* segment = nullptr;
+    MeterFeedLayout::Slot* slot = nullptr;
+    MeterFeedLayout::Payload payload{};
+
+    // setName() hands the new name over; publish() only ever try-locks
+    juce::SpinLock nameLock;
+    char pendingName[MeterFeedLayout::maxNameLength]{};
+    bool nameChanged = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterFeed)
+};
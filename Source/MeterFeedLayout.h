@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+    Shared-memory meter feed: segment layout shared by the plugin and readers.
+    Plain C++ with no JUCE dependency so external tools can include it.
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace MeterFeedLayout
+{
+    // One segment per machine; every plugin instance claims a slot in it
+    constexpr const char* segmentName = "/TrackTweakMeters";
+    constexpr std::uint32_t magic = 0x54544d46; // 'TTMF'
+    constexpr std::uint32_t version = 1;
+    constexpr int numSlots = 256;
+    constexpr int numSpectrumBands = 64;
+    constexpr int maxNameLength = 64;
+
+    // Everything a reader gets for one instance. Copied in and out whole.
+    struct Payload
+    {
+        char name[maxNameLength];
+        std::uint64_t frameCounter;
+        float momentaryLUFS;
+        float shortTermLUFS;
+        float integratedLUFS;
+        float peak;
+        float rms;
+        float spectrum[numSpectrumBands]; // dB, log-spaced 20 Hz - 20 kHz
+    };
+
+    // Seqlock: the sequence is odd while the owner is writing. A reader
+    // retries until it sees the same even value before and after its copy.
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint32_t> ownerPid;  // 0 = free
+        std::atomic<std::uint32_t> sequence;
+        Payload payload;
+    };
+
+    struct Header
+    {
+        std::atomic<std::uint32_t> magic;
+        std::uint32_t version;
+        std::uint32_t numSlots;
+        std::uint32_t slotSize;
+    };
+
+    struct alignas(64) Segment
+    {
+        Header header;
+        Slot slots[numSlots];
+    };
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free,
+                  "Slot atomics must be address-free to live in shared memory");
+
+    //==============================================================================
+    // Writer side: no syscalls, two stores around a memcpy
+    inline void writeSlot(Slot& slot, const Payload& payload) noexcept
+    {
+        const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot.payload, &payload, sizeof(Payload));
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side: false if the writer kept the slot busy for every attempt
+    inline bool readSlot(const Slot& slot, Payload& destination, int maxAttempts = 64) noexcept
+    {
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0)
+                continue;
+
+            std::memcpy(&destination, &slot.payload, sizeof(Payload));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+    Octave / third-octave band level meter (IEC 61260-style filterbank).
+  ==============================================================================
+*/
+
+#include "OctaveBandMeter.h"
+#include "DecibelConversion.h"
+
+namespace
+{
+    constexpr double pi = juce::MathConstants<double>::pi;
+
+    // Bands above this fraction of the sample rate are left inactive
+    constexpr double maxCentreFraction = 0.46;
+    constexpr double maxEdgeFraction = 0.48;
+
+    // A band moves down one stage while its upper edge stays below this
+    // fraction of the current rate (i.e. below 0.2 of the decimated rate)
+    constexpr double decimateBelowFraction = 0.1;
+
+    // Anti-alias low-pass corner, as a fraction of the rate being decimated
+    constexpr double antiAliasFraction = 0.15;
+
+    constexpr double fastTimeConstant = 0.125; // IEC 61672 "F"
+    constexpr double slowTimeConstant = 1.0;   // IEC 61672 "S"
+
+    const double thirdOctaveHalfBandwidth = std::pow(10.0, 1.0 / 20.0); // base-10 band edges
+}
+
+//==============================================================================
+OctaveBandMeter::OctaveBandMeter()
+{
+    for (auto& level : fastLevels)
+        level.store(0.0f);
+
+    for (auto& level : slowLevels)
+        level.store(0.0f);
+}
+
+float OctaveBandMeter::getThirdOctaveCentre(int band)
+{
+    // IEC 61260 base-10 exact mid-band frequencies, band 17 = 1 kHz
+    return static_cast<float>(1000.0 * std::pow(10.0, (band - 17) / 10.0));
+}
+
+float OctaveBandMeter::getOctaveCentre(int band)
+{
+    // Each octave is the energy sum of three thirds, centred on the middle one
+    return getThirdOctaveCentre(band * 3 + 2);
+}
+
+//==============================================================================
+void OctaveBandMeter::prepare(double sampleRate, int maximumBlockSize)
+{
+    // process() works in chunks of maxBlockSize, so a new host block size
+    // never needs a redesign - keep the filter state and levels running
+    if (sampleRate == preparedSampleRate && maxBlockSize > 0)
+        return;
+
+    preparedSampleRate = sampleRate;
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    // Pick the deepest decimation stage each band can run at
+    std::array<int, numThirdOctaveBands> bandStage;
+    bandStage.fill(-1);
+    numStages = 1;
+
+    for (int band = 0; band < numThirdOctaveBands; ++band)
+    {
+        const double centre = getThirdOctaveCentre(band);
+        if (centre >= maxCentreFraction * sampleRate)
+            continue;
+
+        const double highEdge = juce::jmin(centre * thirdOctaveHalfBandwidth, maxEdgeFraction * sampleRate);
+
+        int stage = 0;
+        while (stage + 1 < maxNumStages && highEdge < decimateBelowFraction * sampleRate / (1 << stage))
+            ++stage;
+
+        bandStage[static_cast<size_t>(band)] = stage;
+        numStages = juce::jmax(numStages, stage + 1);
+    }
+
+    for (int stageIndex = 0; stageIndex < maxNumStages; ++stageIndex)
+    {
+        auto& stage = stages[static_cast<size_t>(stageIndex)];
+        stage.groups.clear();
+        stage.input.clear();
+
+        if (stageIndex >= numStages)
+            continue;
+
+        const double stageRate = sampleRate / (1 << stageIndex);
+        stage.input.resize(static_cast<size_t>(maxBlockSize), 0.0f);
+        stage.fastCoeff = static_cast<float>(1.0 - std::exp(-1.0 / (fastTimeConstant * stageRate)));
+        stage.slowCoeff = static_cast<float>(1.0 - std::exp(-1.0 / (slowTimeConstant * stageRate)));
+
+        // Pack this stage's bands into SIMD lanes
+        for (int band = 0; band < numThirdOctaveBands; ++band)
+        {
+            if (bandStage[static_cast<size_t>(band)] != stageIndex)
+                continue;
+
+            int lane = 0;
+            if (stage.groups.empty() || stage.groups.back().bandIndex[numLanes - 1] >= 0)
+            {
+                stage.groups.emplace_back();
+                auto& group = stage.groups.back();
+
+                for (int i = 0; i < numSections; ++i)
+                {
+                    group.b0[i] = group.a1[i] = group.a2[i] = Vec::expand(0.0f);
+                    group.s1[i] = group.s2[i] = Vec::expand(0.0f);
+                }
+
+                group.fastMeanSquare = group.slowMeanSquare = Vec::expand(0.0f);
+                std::fill(std::begin(group.bandIndex), std::end(group.bandIndex), -1);
+            }
+            else
+            {
+                while (stage.groups.back().bandIndex[lane] >= 0)
+                    ++lane;
+            }
+
+            const double centre = getThirdOctaveCentre(band);
+            designBand(stage.groups.back(), lane,
+                centre / thirdOctaveHalfBandwidth,
+                juce::jmin(centre * thirdOctaveHalfBandwidth, maxEdgeFraction * sampleRate),
+                stageRate);
+            stage.groups.back().bandIndex[lane] = band;
+        }
+
+        // 6th-order Butterworth low-pass ahead of the next decimation
+        const double w = 2.0 * pi * antiAliasFraction;
+        const double cosW = std::cos(w);
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            const double q = 1.0 / (2.0 * std::sin((2 * i + 1) * pi / (4.0 * numSections)));
+            const double alpha = std::sin(w) / (2.0 * q);
+            const double a0 = 1.0 + alpha;
+
+            auto& biquad = stage.antiAlias[static_cast<size_t>(i)];
+            biquad.b0 = static_cast<float>((1.0 - cosW) * 0.5 / a0);
+            biquad.b1 = static_cast<float>((1.0 - cosW) / a0);
+            biquad.b2 = biquad.b0;
+            biquad.a1 = static_cast<float>(-2.0 * cosW / a0);
+            biquad.a2 = static_cast<float>((1.0 - alpha) / a0);
+        }
+    }
+
+    reset();
+}
+
+void OctaveBandMeter::designBand(BandGroup& group, int lane, double lowEdge, double highEdge, double stageRate)
+{
+    // Band-pass transform of a 3rd-order Butterworth prototype, with the
+    // band edges pre-warped so the bilinear transform lands them exactly
+    const double k = 2.0 * stageRate;
+    const double w1 = k * std::tan(pi * lowEdge / stageRate);
+    const double w2 = k * std::tan(pi * highEdge / stageRate);
+    const double centreSquared = w1 * w2;
+    const double bandwidth = w2 - w1;
+
+    std::array<double, numSections> b0, a1, a2;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        // s^2 - p.B.s + w0^2 = 0 gives a pole pair per prototype pole;
+        // the upper half-plane root plus its conjugate forms one biquad
+        const auto prototypePole = std::polar(1.0, pi * (2 * i + numSections + 1) / (2.0 * numSections));
+        const auto pb = prototypePole * bandwidth;
+        const auto root = std::sqrt(pb * pb - 4.0 * centreSquared);
+        auto pole = (pb + root) * 0.5;
+
+        if (pole.imag() < 0.0)
+            pole = (pb - root) * 0.5;
+
+        // H(s) = s / (s^2 + a.s + b) through the bilinear transform
+        const double a = -2.0 * pole.real();
+        const double b = std::norm(pole);
+        const double a0 = k * k + a * k + b;
+
+        b0[static_cast<size_t>(i)] = k / a0;
+        a1[static_cast<size_t>(i)] = (2.0 * b - 2.0 * k * k) / a0;
+        a2[static_cast<size_t>(i)] = (k * k - a * k + b) / a0;
+    }
+
+    // Normalise for unity gain at the (warped) mid-band frequency
+    const double centreDigital = 2.0 * std::atan(std::sqrt(centreSquared) / k);
+    const auto z1 = std::polar(1.0, -centreDigital);
+    const auto z2 = z1 * z1;
+
+    double magnitude = 1.0;
+    for (size_t i = 0; i < static_cast<size_t>(numSections); ++i)
+        magnitude *= std::abs(b0[i] * (1.0 - z2) / (1.0 + a1[i] * z1 + a2[i] * z2));
+
+    const double sectionGain = std::pow(1.0 / magnitude, 1.0 / numSections);
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        group.b0[i].set(static_cast<size_t>(lane), static_cast<float>(b0[static_cast<size_t>(i)] * sectionGain));
+        group.a1[i].set(static_cast<size_t>(lane), static_cast<float>(a1[static_cast<size_t>(i)]));
+        group.a2[i].set(static_cast<size_t>(lane), static_cast<float>(a2[static_cast<size_t>(i)]));
+    }
+}
+
+void OctaveBandMeter::reset()
+{
+    for (auto& stage : stages)
+    {
+        for (auto& group : stage.groups)
+        {
+            for (int i = 0; i < numSections; ++i)
+                group.s1[i] = group.s2[i] = Vec::expand(0.0f);
+
+            group.fastMeanSquare = group.slowMeanSquare = Vec::expand(0.0f);
+        }
+
+        for (auto& biquad : stage.antiAlias)
+            biquad.s1 = biquad.s2 = 0.0f;
+
+        stage.numInputSamples = 0;
+        stage.keepNextSample = true;
+    }
+
+    for (auto& level : fastLevels)
+        level.store(0.0f);
+
+    for (auto& level : slowLevels)
+        level.store(0.0f);
+}
+
+//==============================================================================
+template <typename SampleType>
+void OctaveBandMeter::process(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    if (numChannels <= 0 || maxBlockSize == 0)
+        return;
+
+    const float channelGain = 1.0f / static_cast<float>(numChannels);
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        const int chunk = juce::jmin(maxBlockSize, numSamples - offset);
+        auto& first = stages[0];
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(first.input.data(), channels[0] + offset, channelGain, chunk);
+            for (int channel = 1; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::addWithMultiply(first.input.data(), channels[channel] + offset, channelGain, chunk);
+        }
+        else
+        {
+            // The filterbank runs in float; the mix-down is the only conversion
+            for (int n = 0; n < chunk; ++n)
+            {
+                SampleType sum = 0;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    sum += channels[channel][offset + n];
+
+                first.input[static_cast<size_t>(n)] = static_cast<float>(sum) * channelGain;
+            }
+        }
+
+        first.numInputSamples = chunk;
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            processStage(stages[static_cast<size_t>(stage)]);
+
+            if (stage + 1 < numStages)
+                decimateInto(stages[static_cast<size_t>(stage)], stages[static_cast<size_t>(stage + 1)]);
+        }
+    }
+
+    publishLevels();
+}
+
+template void OctaveBandMeter::process<float>(const float* const*, int, int);
+template void OctaveBandMeter::process<double>(const double* const*, int, int);
+
+void OctaveBandMeter::processStage(Stage& stage)
+{
+    const auto fastCoeff = Vec::expand(stage.fastCoeff);
+    const auto slowCoeff = Vec::expand(stage.slowCoeff);
+    const float* input = stage.input.data();
+
+    for (auto& group : stage.groups)
+    {
+        // Work on local copies so the state stays in registers
+        Vec s1[numSections], s2[numSections];
+        for (int i = 0; i < numSections; ++i)
+        {
+            s1[i] = group.s1[i];
+            s2[i] = group.s2[i];
+        }
+
+        auto fast = group.fastMeanSquare;
+        auto slow = group.slowMeanSquare;
+
+        for (int n = 0; n < stage.numInputSamples; ++n)
+        {
+            auto x = Vec::expand(input[n]);
+
+            for (int i = 0; i < numSections; ++i)
+            {
+                const auto bx = group.b0[i] * x;
+                const auto y = bx + s1[i];
+                s1[i] = s2[i] - group.a1[i] * y;
+                s2[i] = Vec::expand(0.0f) - bx - group.a2[i] * y;
+                x = y;
+            }
+
+            const auto power = x * x;
+            fast += (power - fast) * fastCoeff;
+            slow += (power - slow) * slowCoeff;
+        }
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            group.s1[i] = s1[i];
+            group.s2[i] = s2[i];
+        }
+
+        group.fastMeanSquare = fast;
+        group.slowMeanSquare = slow;
+    }
+}
+
+void OctaveBandMeter::decimateInto(Stage& source, Stage& destination)
+{
+    int numOutput = 0;
+
+    for (int n = 0; n < source.numInputSamples; ++n)
+    {
+        float y = source.input[static_cast<size_t>(n)];
+        for (auto& biquad : source.antiAlias)
+            y = biquad.process(y);
+
+        if (source.keepNextSample)
+            destination.input[static_cast<size_t>(numOutput++)] = y;
+
+        source.keepNextSample = !source.keepNextSample;
+    }
+
+    destination.numInputSamples = numOutput;
+}
+
+void OctaveBandMeter::publishLevels()
+{
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        for (const auto& group : stages[static_cast<size_t>(stage)].groups)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const int band = group.bandIndex[lane];
+                if (band < 0)
+                    continue;
+
+                // Display values, published every sub-block: no ordering needed
+                fastLevels[static_cast<size_t>(band)].store(group.fastMeanSquare.get(static_cast<size_t>(lane)), std::memory_order_relaxed);
+                slowLevels[static_cast<size_t>(band)].store(group.slowMeanSquare.get(static_cast<size_t>(lane)), std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+//==============================================================================
+void OctaveBandMeter::getThirdOctaveLevels(float* destination, TimeWeighting weighting) const
+{
+    const auto& levels = weighting == TimeWeighting::fast ? fastLevels : slowLevels;
+
+    // Mean square of a full-scale sine is 0.5, so scale by 2 for dBFS
+    for (size_t band = 0; band < levels.size(); ++band)
+        destination[band] = 2.0f * levels[band].load();
+
+    DecibelConversion::powerToDecibels(destination, destination, numThirdOctaveBands, minimumLevel);
+}
+
+void OctaveBandMeter::getOctaveLevels(float* destination, TimeWeighting weighting) const
+{
+    const auto& levels = weighting == TimeWeighting::fast ? fastLevels : slowLevels;
+
+    for (int band = 0; band < numOctaveBands; ++band)
+    {
+        float meanSquare = 0.0f;
+        for (int third = band * 3 + 1; third <= band * 3 + 3; ++third)
+            meanSquare += levels[static_cast<size_t>(third)].load();
+
+        destination[band] = 2.0f * meanSquare;
+    }
+
+    DecibelConversion::powerToDecibels(destination, destination, numOctaveBands, minimumLevel);
+}
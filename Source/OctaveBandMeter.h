@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+    Octave / third-octave band level meter (IEC 61260-style filterbank).
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+// Time-domain band meter: 31 third-octave bands (20 Hz - 20 kHz) built from
+// 6th-order Butterworth band-passes. Bands are packed into SIMD registers so
+// that one lane filters one band, and the lower octaves run on a chain of
+// decimate-by-2 stages so their filters stay well conditioned and cheap.
+class OctaveBandMeter
+{
+public:
+    static constexpr int numThirdOctaveBands = 31;
+    static constexpr int numOctaveBands = 10;
+
+    enum class TimeWeighting { fast, slow };
+
+    OctaveBandMeter();
+
+    // Not real-time safe: call from prepareToPlay. Only a sample-rate change
+    // rebuilds the filterbank; a new block size keeps the running state.
+    void prepare(double sampleRate, int maximumBlockSize);
+    void reset();
+
+    // Audio thread: mixes the channels to mono and runs the filterbank.
+    // Instantiated for float and double host buffers.
+    template <typename SampleType>
+    void process(const SampleType* const* channels, int numChannels, int numSamples);
+
+    // GUI access - levels in dBFS (a full-scale sine inside a band reads 0 dB)
+    void getThirdOctaveLevels(float* destination, TimeWeighting weighting) const;
+    void getOctaveLevels(float* destination, TimeWeighting weighting) const;
+
+    static float getThirdOctaveCentre(int band);
+    static float getOctaveCentre(int band);
+
+    static constexpr float minimumLevel = -100.0f;
+
+private:
+    //==============================================================================
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = static_cast<int>(Vec::SIMDNumElements);
+    static constexpr int numSections = 3;   // 3 biquads = 6th-order band-pass
+    static constexpr int maxNumStages = 10; // full rate down to fs / 512
+
+    // numLanes bands sharing one stage's sample stream
+    struct BandGroup
+    {
+        Vec b0[numSections], a1[numSections], a2[numSections]; // b1 = 0, b2 = -b0
+        Vec s1[numSections], s2[numSections];
+        Vec fastMeanSquare, slowMeanSquare;
+        int bandIndex[numLanes];
+    };
+
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float s1 = 0.0f, s2 = 0.0f;
+
+        float process(float x) noexcept
+        {
+            auto y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    struct Stage
+    {
+        std::vector<BandGroup> groups;
+        std::array<Biquad, numSections> antiAlias; // low-pass feeding the next stage
+        std::vector<float> input;
+        int numInputSamples = 0;
+        bool keepNextSample = true;
+        float fastCoeff = 0.0f, slowCoeff = 0.0f;
+    };
+
+    void designBand(BandGroup& group, int lane, double lowEdge, double highEdge, double stageRate);
+    void processStage(Stage& stage);
+    void decimateInto(Stage& source, Stage& destination);
+    void publishLevels();
+
+    std::array<Stage, maxNumStages> stages;
+    int numStages = 0;
+    int maxBlockSize = 0;
+    double preparedSampleRate = 0.0;
+
+    std::array<std::atomic<float>, numThirdOctaveBands> fastLevels;
+    std::array<std::atomic<float>, numThirdOctaveBands> slowLevels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OctaveBandMeter)
+};
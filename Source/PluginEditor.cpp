@@ -9,163 +9,513 @@
 
 //==============================================================================
 TrackTweakAudioProcessorEditor::TrackTweakAudioProcessorEditor(TrackTweakAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), assets(p.getEditorAssets()),
+      cachedFrame(assets.getFrame(&p))
 {
-    // Setup section titles with professional styling
-    addAndMakeVisible(rmsTitle);
-    rmsTitle.setText("RMS LEVEL", juce::dontSendNotification);
-    rmsTitle.setJustificationType(juce::Justification::centred);
-    rmsTitle.setFont(juce::FontOptions(14.0f, juce::Font::bold));
-    rmsTitle.setColour(juce::Label::textColourId, juce::Colour(0xff4da6ff)); // Professional blue
-
-    addAndMakeVisible(lufsTitle);
-    lufsTitle.setText("LUFS LOUDNESS", juce::dontSendNotification);
-    lufsTitle.setJustificationType(juce::Justification::centred);
-    lufsTitle.setFont(juce::FontOptions(14.0f, juce::Font::bold));
-    lufsTitle.setColour(juce::Label::textColourId, juce::Colour(0xff66cc66)); // Professional green
-
-    addAndMakeVisible(spectrumTitle);
-    spectrumTitle.setText("SPECTRUM ANALYZER", juce::dontSendNotification);
-    spectrumTitle.setJustificationType(juce::Justification::centred);
-    spectrumTitle.setFont(juce::FontOptions(14.0f, juce::Font::bold));
-    spectrumTitle.setColour(juce::Label::textColourId, juce::Colour(0xffff9933)); // Professional orange
-
-    // Setup RMS label
-    addAndMakeVisible(rmsLabel);
-    rmsLabel.setText("RMS: 0.000", juce::dontSendNotification);
-    rmsLabel.setJustificationType(juce::Justification::centred);
-    rmsLabel.setFont(juce::FontOptions(12.0f));
-
-    // Setup LUFS labels
-    addAndMakeVisible(momentaryLUFSLabel);
-    momentaryLUFSLabel.setText("Momentary: -70.0 LUFS", juce::dontSendNotification);
-    momentaryLUFSLabel.setJustificationType(juce::Justification::centred);
-    momentaryLUFSLabel.setFont(juce::FontOptions(12.0f));
-
-    addAndMakeVisible(shortTermLUFSLabel);
-    shortTermLUFSLabel.setText("Short-term: -70.0 LUFS", juce::dontSendNotification);
-    shortTermLUFSLabel.setJustificationType(juce::Justification::centred);
-    shortTermLUFSLabel.setFont(juce::FontOptions(12.0f));
-
-    addAndMakeVisible(integratedLUFSLabel);
-    integratedLUFSLabel.setText("Integrated: -70.0 LUFS", juce::dontSendNotification);
-    integratedLUFSLabel.setJustificationType(juce::Justification::centred);
-    integratedLUFSLabel.setFont(juce::FontOptions(12.0f));
-
-    // Setup tip label
-    addAndMakeVisible(tipLabel);
-    tipLabel.setText("Tip: Waiting for signal...", juce::dontSendNotification);
-    tipLabel.setJustificationType(juce::Justification::centred);
-    tipLabel.setFont(juce::FontOptions(11.0f));
-    tipLabel.setColour(juce::Label::textColourId, juce::Colour(0xffffcc66)); // Soft yellow
-
-    // Setup professional spectrum analyzer
-    spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>(audioProcessor);
-    addAndMakeVisible(*spectrumAnalyzer);
+    // Only the cached frame (or the shared background) is drawn at first;
+    // the controls and views are built over the timer ticks after it has
+    // been painted
+    setOpaque(true);
 
     // Start timer to update display (30 FPS)
     startTimer(33);
 
-    setSize(600, 650); // Optimized size for all components
+    setSize(680, 930); // Optimized size for all components
+}
+
+bool TrackTweakAudioProcessorEditor::buildNextViews()
+{
+    // A step per timer tick, so the message thread can paint and take
+    // input in between. The views are sized and shown only at the end,
+    // over the cached frame until then.
+    switch (nextBuildStep++)
+    {
+        case 0:
+            // Setup professional spectrum analyzer
+            spectrumAnalyzer = std::make_unique<SpectrumAnalyzer>(audioProcessor);
+            addAndMakeVisible(*spectrumAnalyzer);
+            return false;
+
+        case 1:
+        {
+            // Setup section titles with professional styling
+            addAndMakeVisible(rmsTitle);
+            rmsTitle.setText("RMS LEVEL", juce::dontSendNotification);
+            rmsTitle.setJustificationType(juce::Justification::centred);
+            rmsTitle.setFont(assets.getTitleFont());
+            rmsTitle.setColour(juce::Label::textColourId, juce::Colour(0xff4da6ff)); // Professional blue
+
+            addAndMakeVisible(lufsTitle);
+            lufsTitle.setText("LUFS LOUDNESS", juce::dontSendNotification);
+            lufsTitle.setJustificationType(juce::Justification::centred);
+            lufsTitle.setFont(assets.getTitleFont());
+            lufsTitle.setColour(juce::Label::textColourId, juce::Colour(0xff66cc66)); // Professional green
+
+            addAndMakeVisible(spectrumTitle);
+            spectrumTitle.setText("SPECTRUM ANALYZER", juce::dontSendNotification);
+            spectrumTitle.setJustificationType(juce::Justification::centred);
+            spectrumTitle.setFont(assets.getTitleFont());
+            spectrumTitle.setColour(juce::Label::textColourId, juce::Colour(0xffff9933)); // Professional orange
+
+            addAndMakeVisible(bandsTitle);
+            bandsTitle.setText("OCTAVE BANDS", juce::dontSendNotification);
+            bandsTitle.setJustificationType(juce::Justification::centred);
+            bandsTitle.setFont(assets.getTitleFont());
+            bandsTitle.setColour(juce::Label::textColourId, juce::Colour(0xffff9933));
+
+            addAndMakeVisible(timelineTitle);
+            timelineTitle.setText("TIMELINE LOUDNESS", juce::dontSendNotification);
+            timelineTitle.setJustificationType(juce::Justification::centred);
+            timelineTitle.setFont(assets.getTitleFont());
+            timelineTitle.setColour(juce::Label::textColourId, juce::Colour(0xff66cc66));
+
+            // Level bars and numeric readouts; they redraw only what changed
+            addAndMakeVisible(rmsMeter);
+            addAndMakeVisible(peakMeter);
+            addAndMakeVisible(truePeakReadout);
+            addAndMakeVisible(momentaryReadout);
+            addAndMakeVisible(shortTermReadout);
+            addAndMakeVisible(integratedReadout);
+            addAndMakeVisible(dynamicsReadout);
+            addAndMakeVisible(costReadout);
+
+            // Setup tip label
+            addAndMakeVisible(tipLabel);
+            tipLabel.setText("Tip: Waiting for signal...", juce::dontSendNotification);
+            tipLabel.setJustificationType(juce::Justification::centred);
+            tipLabel.setFont(juce::FontOptions(11.0f));
+            tipLabel.setColour(juce::Label::textColourId, juce::Colour(0xffffcc66)); // Soft yellow
+
+            // Analyzer selectors are attached to the host parameters, so automation
+            // and the controls stay in step. Item ids are the choice index + 1.
+            auto& parameters = audioProcessor.getParameters();
+
+            addAndMakeVisible(fftSizeBox);
+            for (int order = SpectrumEngine::minFFTOrder; order <= SpectrumEngine::maxFFTOrder; ++order)
+                fftSizeBox.addItem(juce::String(1 << order), order - SpectrumEngine::minFFTOrder + 1);
+
+            addAndMakeVisible(windowBox);
+            windowBox.addItem("Hann", 1);
+            windowBox.addItem("Blackman-Harris", 2);
+            windowBox.addItem("Flat-top", 3);
+            windowBox.addItem("Kaiser", 4);
+
+            addAndMakeVisible(channelModeBox);
+            channelModeBox.addItem("L / R", 1);
+            channelModeBox.addItem("M / S", 2);
+
+            // Averaging is done in linear power
+            addAndMakeVisible(averagingBox);
+            averagingBox.addItem("Exp avg", 1);
+            averagingBox.addItem("RMS x8", 2);
+            averagingBox.addItem("Infinite", 3);
+
+            addAndMakeVisible(smoothingBox);
+            for (size_t i = 0; i < SpectrumSmoother::fractions.size(); ++i)
+            {
+                const int fraction = SpectrumSmoother::fractions[i];
+                smoothingBox.addItem(fraction == 0 ? juce::String("No smooth") : "1/" + juce::String(fraction) + " oct",
+                                     static_cast<int>(i) + 1);
+            }
+
+            addAndMakeVisible(longTermTitle);
+            longTermTitle.setText("Long-term average vs target", juce::dontSendNotification);
+            longTermTitle.setJustificationType(juce::Justification::centredRight);
+            longTermTitle.setFont(juce::FontOptions(11.0f));
+
+            addAndMakeVisible(targetBox);
+            for (int genre = 0; genre < SpectrumTargets::numGenres; ++genre)
+                targetBox.addItem(SpectrumTargets::getName(static_cast<SpectrumTargets::Genre>(genre)), genre + 1);
+
+            const std::array<std::pair<juce::ComboBox*, const char*>, 6> attachedBoxes{ {
+                { &fftSizeBox, AnalyzerSettings::fftSizeID },
+                { &windowBox, AnalyzerSettings::windowID },
+                { &channelModeBox, AnalyzerSettings::channelModeID },
+                { &averagingBox, AnalyzerSettings::averagingID },
+                { &smoothingBox, AnalyzerSettings::smoothingID },
+                { &targetBox, AnalyzerSettings::targetCurveID } } };
+
+            for (size_t i = 0; i < attachedBoxes.size(); ++i)
+                comboBoxAttachments[i] = std::make_unique<ComboBoxAttachment>(parameters, attachedBoxes[i].second,
+                                                                              *attachedBoxes[i].first);
+
+            // A/B snapshots, named after the track and the time of capture
+            addAndMakeVisible(snapshotBox);
+            snapshotBox.setTextWhenNothingSelected("No A/B");
+            snapshotBox.onChange = [this]
+            {
+                const auto* snapshot = audioProcessor.getSnapshotStore().getSnapshot(snapshotBox.getSelectedId() - 2);
+                overlaySnapshot = snapshot != nullptr ? snapshot->createdMilliseconds : 0;
+                deleteSnapshotButton.setEnabled(snapshot != nullptr);
+                spectrumAnalyzer->setOverlay(snapshotBox.getSelectedId() - 2);
+            };
+
+            addAndMakeVisible(captureButton);
+            captureButton.onClick = [this]
+            {
+                const auto* entry = audioProcessor.getRegistryEntry();
+                const auto source = entry != nullptr ? entry->getName() : audioProcessor.getName();
+                audioProcessor.captureSnapshot(source + " " + juce::Time::getCurrentTime().formatted("%d %b %H:%M:%S"));
+            };
+
+            addAndMakeVisible(deleteSnapshotButton);
+            deleteSnapshotButton.onClick = [this]
+            {
+                if (overlaySnapshot != 0)
+                    audioProcessor.getSnapshotStore().remove(overlaySnapshot);
+            };
+
+            audioProcessor.getSnapshotStore().addChangeListener(this);
+            updateSnapshotList();
+
+            // Mark on: the average starts again from here. Mark off: it is held,
+            // covering just the marked stretch.
+            addAndMakeVisible(markButton);
+            markButton.setClickingTogglesState(true);
+            markButton.onClick = [this]
+            {
+                auto& engine = audioProcessor.getSpectrumEngine();
+
+                if (markButton.getToggleState())
+                    engine.resetLongTermAverage();
+
+                engine.setLongTermAverageRunning(markButton.getToggleState());
+            };
+
+            addAndMakeVisible(noiseCalibrationButton);
+            noiseCalibrationAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+                parameters, AnalyzerSettings::noiseCalibrationID, noiseCalibrationButton);
+            return false;
+        }
+
+        case 2:
+            // Setup octave band display
+            bandLevelDisplay = std::make_unique<BandLevelDisplay>(audioProcessor);
+            addAndMakeVisible(*bandLevelDisplay);
+            return false;
+
+        case 3:
+            // Timeline loudness from the block cache
+            timelineView = std::make_unique<TimelineLoudnessView>(audioProcessor.getLoudnessTimeline());
+            addAndMakeVisible(*timelineView);
+            return false;
+
+        default:
+            break;
+    }
+
+    // Overview of every instance in the process, toggled over the meters;
+    // built the first time it is shown
+    addAndMakeVisible(overviewButton);
+    overviewButton.setClickingTogglesState(true);
+    overviewButton.onClick = [this]
+    {
+        if (overviewButton.getToggleState())
+        {
+            eventsButton.setToggleState(false, juce::dontSendNotification);
+            eventList->setVisible(false);
+        }
+
+        if (instanceOverview == nullptr)
+        {
+            instanceOverview = std::make_unique<InstanceOverview>(audioProcessor.getRegistryEntry());
+            addChildComponent(*instanceOverview);
+            resized();
+        }
+
+        instanceOverview->setVisible(overviewButton.getToggleState());
+        instanceOverview->refresh();
+    };
+
+    // Events, drained by the timer whether shown or not; clicking one
+    // selects it on the timeline
+    eventList = std::make_unique<EventList>(audioProcessor.getEventDetector());
+    addChildComponent(*eventList);
+
+    eventList->onEventClicked = [this](const MeterEvent& event)
+    {
+        const auto length = event.type == MeterEvent::Type::silence
+            ? static_cast<juce::int64>(event.value * audioProcessor.getSampleRate())
+            : juce::int64(0);
+
+        timelineView->selectSamples(event.timelineSample, event.timelineSample + length);
+        eventsButton.setToggleState(false, juce::dontSendNotification);
+        eventList->setVisible(false);
+    };
+
+    addAndMakeVisible(eventsButton);
+    eventsButton.setClickingTogglesState(true);
+    eventsButton.onClick = [this]
+    {
+        if (eventsButton.getToggleState())
+        {
+            overviewButton.setToggleState(false, juce::dontSendNotification);
+
+            if (instanceOverview != nullptr)
+                instanceOverview->setVisible(false);
+        }
+
+        eventList->setVisible(eventsButton.getToggleState());
+    };
+
+    // From here on the live views are drawn instead of the cached frame
+    viewsBuilt = true;
+    cachedFrame = {};
+    resized();
+    repaint();
+
+    readyMilliseconds = getMillisecondsSinceOpened();
+
+   #if TRACKTWEAK_TRACING
+    TraceRecorder::getInstance().recordSince("editorOpen", openedTicks);
+   #endif
+    return true;
+}
+
+float TrackTweakAudioProcessorEditor::getMillisecondsSinceOpened() const
+{
+    return static_cast<float>(1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - openedTicks));
 }
 
 TrackTweakAudioProcessorEditor::~TrackTweakAudioProcessorEditor()
 {
     stopTimer();
+    audioProcessor.getSnapshotStore().removeChangeListener(this);
+
+    // Kept, opaque, so this instance's editor opens on it next time
+    if (viewsBuilt)
+        assets.storeFrame(&audioProcessor, createComponentSnapshot(getLocalBounds(), true, 1.0f)
+                                               .convertedToFormat(juce::Image::RGB));
 }
 
 //==============================================================================
 void TrackTweakAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Until the controls are built, the last frame this instance's editor
+    // showed stands in for them
+    if (! viewsBuilt && cachedFrame.isValid())
+    {
+        g.drawImage(cachedFrame, getLocalBounds().toFloat());
+    }
+    else
+    {
+        const auto& background = assets.getBackground(getWidth(), getHeight(), paintBackground);
+        g.drawImage(background, 0, 0, getWidth(), getHeight(), 0, 0, background.getWidth(), background.getHeight());
+    }
+
+    if (firstPaintMilliseconds < 0.0f)
+        firstPaintMilliseconds = getMillisecondsSinceOpened();
+}
+
+void TrackTweakAudioProcessorEditor::paintBackground(juce::Graphics& g, int width, int height)
 {
     // Professional gradient background
     juce::ColourGradient gradient(juce::Colour(0xff1a1a1a), 0, 0,
-        juce::Colour(0xff2d2d30), 0, getHeight(), false);
+        juce::Colour(0xff2d2d30), 0, height, false);
     g.setGradientFill(gradient);
     g.fillAll();
 
     // Professional plugin title
     g.setColour(juce::Colours::white);
     g.setFont(juce::FontOptions(20.0f, juce::Font::bold));
-    g.drawFittedText("TrackTweak Pro Analyzer", getLocalBounds().removeFromTop(45),
+    g.drawFittedText("TrackTweak Pro Analyzer", juce::Rectangle<int>(width, height).removeFromTop(45),
         juce::Justification::centred, 1);
 
     // FIXED: Adjusted separator line positions to match actual layout
     g.setColour(juce::Colours::grey.withAlpha(0.25f));
-    g.drawHorizontalLine(130, 20, getWidth() - 20);  // After RMS
-    g.drawHorizontalLine(245, 20, getWidth() - 20);  // After LUFS, before spectrum (adjusted position)
+    g.drawHorizontalLine(130, 20, width - 20);  // After RMS
+    g.drawHorizontalLine(270, 20, width - 20);  // After LUFS, before spectrum (adjusted position)
 }
 
 void TrackTweakAudioProcessorEditor::resized()
 {
+    if (! viewsBuilt)
+        return;
+
     auto bounds = getLocalBounds();
-    bounds.removeFromTop(50); // Title space
+    auto header = bounds.removeFromTop(50);
+    overviewButton.setBounds(header.removeFromRight(95).reduced(10, 12));
+    eventsButton.setBounds(header.removeFromRight(85).reduced(0, 12));
+    eventList->setBounds(bounds.reduced(10, 0));
+
+    if (instanceOverview != nullptr)
+        instanceOverview->setBounds(bounds.reduced(10, 0));
 
     // RMS section
     rmsTitle.setBounds(bounds.removeFromTop(25).reduced(10, 0));
-    rmsLabel.setBounds(bounds.removeFromTop(30).reduced(10, 0));
+    auto levelRow = bounds.removeFromTop(30).reduced(10, 0);
+    truePeakReadout.setBounds(levelRow.removeFromRight(160));
+    rmsMeter.setBounds(levelRow.removeFromLeft(levelRow.getWidth() / 2).reduced(5, 0));
+    peakMeter.setBounds(levelRow.reduced(5, 0));
     bounds.removeFromTop(15); // Spacing
 
     // LUFS section 
     bounds.removeFromTop(10); // Extra spacing to move title below line
     lufsTitle.setBounds(bounds.removeFromTop(25).reduced(10, 0));
-    momentaryLUFSLabel.setBounds(bounds.removeFromTop(25).reduced(10, 0));
-    shortTermLUFSLabel.setBounds(bounds.removeFromTop(25).reduced(10, 0));
-    integratedLUFSLabel.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    momentaryReadout.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    shortTermReadout.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    integratedReadout.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    dynamicsReadout.setBounds(bounds.removeFromTop(25).reduced(10, 0));
     bounds.removeFromTop(15); // Spacing after LUFS
 
     // Spectrum section - title and analyzer both BELOW the line
     bounds.removeFromTop(10); // Space after separator line
-    spectrumTitle.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    auto spectrumHeader = bounds.removeFromTop(25).reduced(15, 0);
+    noiseCalibrationButton.setBounds(spectrumHeader.removeFromRight(65));
+    windowBox.setBounds(spectrumHeader.removeFromRight(120).reduced(2, 1));
+    fftSizeBox.setBounds(spectrumHeader.removeFromRight(75).reduced(2, 1));
+    channelModeBox.setBounds(spectrumHeader.removeFromLeft(70).reduced(2, 1));
+    averagingBox.setBounds(spectrumHeader.removeFromLeft(85).reduced(2, 1));
+    smoothingBox.setBounds(spectrumHeader.removeFromLeft(90).reduced(2, 1));
+    spectrumTitle.setBounds(spectrumHeader);
+
+    auto longTermHeader = bounds.removeFromTop(25).reduced(15, 0);
+    markButton.setBounds(longTermHeader.removeFromRight(60).reduced(2, 1));
+    targetBox.setBounds(longTermHeader.removeFromRight(130).reduced(2, 1));
+    captureButton.setBounds(longTermHeader.removeFromLeft(70).reduced(2, 1));
+    snapshotBox.setBounds(longTermHeader.removeFromLeft(170).reduced(2, 1));
+    deleteSnapshotButton.setBounds(longTermHeader.removeFromLeft(25).reduced(2, 1));
+    longTermTitle.setBounds(longTermHeader);
     bounds.removeFromTop(5); // Small spacing between title and analyzer
     spectrumAnalyzer->setBounds(bounds.removeFromTop(200).reduced(15, 0));
     bounds.removeFromTop(15); // Spacing
 
+    // Octave band section
+    bandsTitle.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    bounds.removeFromTop(5);
+    bandLevelDisplay->setBounds(bounds.removeFromTop(120).reduced(15, 0));
+    bounds.removeFromTop(15); // Spacing
+
+    // Timeline section
+    timelineTitle.setBounds(bounds.removeFromTop(25).reduced(10, 0));
+    bounds.removeFromTop(5);
+    timelineView->setBounds(bounds.removeFromTop(90).reduced(15, 0));
+    bounds.removeFromTop(15); // Spacing
+
     // Tip section
-    tipLabel.setBounds(bounds.removeFromTop(60).reduced(10, 5));
+    tipLabel.setBounds(bounds.removeFromTop(35).reduced(10, 5));
+    costReadout.setBounds(bounds.removeFromTop(25).reduced(10, 0));
 }
 
 void TrackTweakAudioProcessorEditor::timerCallback()
 {
-    // Get current values
-    float rms = audioProcessor.getRMSLevel();
-    float momentaryLUFS = audioProcessor.getMomentaryLUFS();
-    float shortTermLUFS = audioProcessor.getShortTermLUFS();
-    float integratedLUFS = audioProcessor.getIntegratedLUFS();
-
-    // Update RMS display
-    rmsLabel.setText("RMS: " + juce::String(rms, 3), juce::dontSendNotification);
-
-    // Update LUFS displays
-    momentaryLUFSLabel.setText("Momentary: " + juce::String(momentaryLUFS, 1) + " LUFS",
-        juce::dontSendNotification);
-    shortTermLUFSLabel.setText("Short-term: " + juce::String(shortTermLUFS, 1) + " LUFS",
-        juce::dontSendNotification);
-    integratedLUFSLabel.setText("Integrated: " + juce::String(integratedLUFS, 1) + " LUFS",
-        juce::dontSendNotification);
-
-    // Professional color coding based on broadcast/streaming standards
+    TRACKTWEAK_TRACE_SCOPE("timerCallback");
+
+    if (! viewsBuilt)
+    {
+        // Quick ticks while building, then back to 30 FPS
+        if (firstPaintMilliseconds >= 0.0f)
+            startTimer(buildNextViews() ? 33 : 1);
+
+        return;
+    }
+
+    // Ballistics run on the real time between frames
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const float seconds = lastFrameTime > 0.0 ? static_cast<float>((now - lastFrameTime) * 0.001) : 0.0f;
+    lastFrameTime = now;
+
+    const float shortTermLUFS = audioProcessor.getShortTermLUFS();
+
+    rmsMeter.setLevel(audioProcessor.getRMSLevel(), seconds);
+    peakMeter.setLevel(audioProcessor.getPeakLevel(), seconds);
+    truePeakReadout.setValue(0, audioProcessor.getTruePeakDecibels());
+
+    momentaryReadout.setValue(0, audioProcessor.getMomentaryLUFS());
+    shortTermReadout.setValue(0, shortTermLUFS);
+    integratedReadout.setValue(0, audioProcessor.getIntegratedLUFS());
+    integratedReadout.setValue(1, audioProcessor.getLoudnessRange());
+
+    // Low PSR / DR means heavy limiting
+    const float psr = audioProcessor.getPeakToShortTermRatio();
+    dynamicsReadout.setValue(0, audioProcessor.getCrestFactor());
+    dynamicsReadout.setValue(1, audioProcessor.getPeakToLoudnessRatio());
+    dynamicsReadout.setValue(2, psr);
+    dynamicsReadout.setValue(3, audioProcessor.getDynamicRange());
+    dynamicsReadout.setValueColour(2, psr > 0.0f && psr < 6.0f ? juce::Colour(0xffff8844) : juce::Colours::white);
+
+    // Callback cost over the last second; a high ratio means bursty work
+    const auto& cost = audioProcessor.getProcessingCost();
+    costReadout.setValue(0, cost.getAverageMicroseconds());
+    costReadout.setValue(1, cost.getPeakMicroseconds());
+    costReadout.setValue(2, cost.getPeakToAverage());
+    costReadout.setValue(3, firstPaintMilliseconds);
+    costReadout.setValue(4, readyMilliseconds);
+
+    // Color coding against the loudness target and its tolerance
+    const auto& settings = audioProcessor.getAnalyzerSettings();
     juce::Colour lufsColor = juce::Colours::white;
-    if (shortTermLUFS > -14.0f)
-        lufsColor = juce::Colour(0xffff4444);      // Red: Too loud for streaming
-    else if (shortTermLUFS > -16.0f)
-        lufsColor = juce::Colour(0xffff8844);      // Orange: Getting loud
-    else if (shortTermLUFS > -23.0f)
-        lufsColor = juce::Colour(0xff44ff44);      // Green: Perfect range
+    if (shortTermLUFS > settings.loudnessTarget + settings.loudnessTolerance)
+        lufsColor = juce::Colour(0xffff4444);      // Red: Above the target range
+    else if (shortTermLUFS > settings.loudnessTarget)
+        lufsColor = juce::Colour(0xffff8844);      // Orange: Upper half of the range
+    else if (shortTermLUFS > settings.loudnessTarget - settings.loudnessTolerance)
+        lufsColor = juce::Colour(0xff44ff44);      // Green: Lower half of the range
     else if (shortTermLUFS > -35.0f)
         lufsColor = juce::Colour(0xffffff44);      // Yellow: Quiet but OK
     else
         lufsColor = juce::Colour(0xff888888);      // Grey: Very quiet
 
-    shortTermLUFSLabel.setColour(juce::Label::textColourId, lufsColor);
+    shortTermReadout.setValueColour(0, lufsColor);
 
     // Update spectrum analyzer (repaints automatically)
     spectrumAnalyzer->repaint();
+    bandLevelDisplay->repaint();
+    timelineView->repaint();
+
+    if (instanceOverview != nullptr && instanceOverview->isVisible())
+        instanceOverview->refresh();
+
+    eventList->setSampleRate(audioProcessor.getSampleRate());
+
+    // Snapshots captured in other processes, checked about once a second
+    if (--framesUntilStoreCheck <= 0)
+    {
+        framesUntilStoreCheck = 30;
+        audioProcessor.getSnapshotStore().refresh();
+    }
+
+    if (eventList->drain())
+        eventsButton.setButtonText("Events (" + juce::String(eventList->getNumEvents()) + ")");
+
+    // Intelligent advice based on content type and levels; the label is
+    // only touched when the advice changes
+    if (const char* tip = getLUFSAdvice(shortTermLUFS); tip != currentTip)
+    {
+        currentTip = tip;
+        tipLabel.setText(tip, juce::dontSendNotification);
+    }
+}
+
+void TrackTweakAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updateSnapshotList();
+}
+
+void TrackTweakAudioProcessorEditor::updateSnapshotList()
+{
+    // Item id is the store index + 2; id 1 turns the overlay off
+    const auto& store = audioProcessor.getSnapshotStore();
+    snapshotBox.clear(juce::dontSendNotification);
+    snapshotBox.addItem("No A/B", 1);
+
+    for (int i = 0; i < store.getNumSnapshots(); ++i)
+    {
+        const auto& snapshot = *store.getSnapshot(i);
+        snapshotBox.addItem(SnapshotStore::getName(snapshot) + "  " + juce::String(snapshot.integratedLUFS, 1) + " LUFS", i + 2);
+    }
+
+    const int overlayIndex = overlaySnapshot != 0 ? store.indexOf(overlaySnapshot) : -1;
+
+    if (overlayIndex < 0)
+        overlaySnapshot = 0;
 
-    // Intelligent advice based on content type and levels
-    tipLabel.setText(getLUFSAdvice(shortTermLUFS), juce::dontSendNotification);
+    snapshotBox.setSelectedId(overlayIndex + 2, juce::dontSendNotification);
+    deleteSnapshotButton.setEnabled(overlayIndex >= 0);
+    spectrumAnalyzer->setOverlay(overlayIndex);
 }
 
-juce::String TrackTweakAudioProcessorEditor::getLUFSAdvice(float lufs) const
+const char* TrackTweakAudioProcessorEditor::getLUFSAdvice(float lufs) const
 {
     // Intelligent advice for both music production and microphone input
     if (lufs <= -60.0f)
@@ -7,6 +7,9 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "DecibelConversion.h"
+#include "EditorAssets.h"
+#include "MeterComponents.h"
 
 //==============================================================================
 // FIXED: Professional Ableton-Style Spectrum Analyzer Component
@@ -20,6 +23,8 @@ public:
 
     void paint(juce::Graphics& g) override
     {
+        TRACKTWEAK_TRACE_SCOPE("SpectrumAnalyzer::paint");
+
         // Professional dark background like Ableton
         g.fillAll(juce::Colour(0xff1a1a1a));
 
@@ -37,25 +42,31 @@ public:
         auto width = bounds.getWidth();
         auto height = bounds.getHeight();
 
+        // Level axis from the settings snapshot
+        const auto& settings = audioProcessor.getAnalyzerSettings();
+        const float floordB = settings.displayFloor, ceilingdB = settings.displayCeiling;
+        auto toY = [=](float dB) { return juce::jmap(juce::jlimit(floordB, ceilingdB, dB), floordB, ceilingdB, height, 0.0f); };
+        const int firstGridLine = static_cast<int>(std::ceil(floordB / 20.0f)) * 20;
+
         // IMPROVED: Professional grid system
         g.setColour(juce::Colours::grey.withAlpha(0.15f));
 
-        // Frequency grid lines with better spacing
+        // Frequency grid lines on the same log axis as the display columns
         std::vector<std::pair<float, juce::String>> freqMarkers = {
-            {0.1f, "100"}, {0.2f, "200"}, {0.35f, "500"}, {0.5f, "1k"},
-            {0.65f, "2k"}, {0.78f, "5k"}, {0.88f, "10k"}
+            {100.0f, "100"}, {200.0f, "200"}, {500.0f, "500"}, {1000.0f, "1k"},
+            {2000.0f, "2k"}, {5000.0f, "5k"}, {10000.0f, "10k"}
         };
 
         for (const auto& marker : freqMarkers)
         {
-            float x = width * marker.first;
+            float x = width * SpectrumEngine::frequencyToDisplayPosition(marker.first);
             g.drawVerticalLine(static_cast<int>(x), 0, height);
         }
 
         // IMPROVED: dB grid with better range
-        for (int dB = -80; dB <= 0; dB += 20)
+        for (int dB = firstGridLine; dB <= ceilingdB; dB += 20)
         {
-            float y = juce::jmap(static_cast<float>(dB), -80.0f, 0.0f, height, 0.0f);
+            float y = toY(static_cast<float>(dB));
             g.drawHorizontalLine(static_cast<int>(y), 0, width);
         }
 
@@ -65,16 +76,16 @@ public:
 
         for (const auto& marker : freqMarkers)
         {
-            float x = width * marker.first;
+            float x = width * SpectrumEngine::frequencyToDisplayPosition(marker.first);
             g.drawText(marker.second, static_cast<int>(x - 15), static_cast<int>(height - 15),
                 30, 12, juce::Justification::centred);
         }
 
         // dB scale labels
         g.setFont(juce::FontOptions(8.0f));
-        for (int dB = -60; dB <= 0; dB += 20)
+        for (int dB = firstGridLine + 20; dB <= ceilingdB; dB += 20)
         {
-            float y = juce::jmap(static_cast<float>(dB), -80.0f, 0.0f, height, 0.0f);
+            float y = toY(static_cast<float>(dB));
             g.drawText(juce::String(dB), 2, static_cast<int>(y - 6), 25, 12,
                 juce::Justification::left);
         }
@@ -89,11 +100,10 @@ public:
             auto magnitude = spectrumData[i];
 
             // IMPROVED: Better range mapping with extended low end
-            magnitude = juce::jlimit(-80.0f, 0.0f, magnitude);
+            magnitude = juce::jlimit(floordB, ceilingdB, magnitude);
 
-            auto x = juce::jmap(static_cast<float>(i), 0.0f,
-                static_cast<float>(spectrumData.size() - 1), 0.0f, width);
-            auto y = juce::jmap(magnitude, -80.0f, 0.0f, height, 0.0f);
+            auto x = columnX[static_cast<size_t>(i)];
+            auto y = toY(magnitude);
 
             if (firstPoint)
             {
@@ -138,13 +148,207 @@ public:
         g.setOpacity(1.0f);
         g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
 
+        // Second channel (right or side) from the same packed FFT, line only
+        auto& engine = audioProcessor.getSpectrumEngine();
+        const bool midSide = settings.channelMode == AnalyzerSettings::ChannelMode::midSide;
+
+        if (engine.isStereo())
+        {
+            audioProcessor.getSpectrumData(secondTraceData, 1);
+
+            juce::Path secondPath;
+            for (int i = 0; i < static_cast<int>(secondTraceData.size()); ++i)
+            {
+                auto x = columnX[static_cast<size_t>(i)];
+                auto y = toY(secondTraceData[i]);
+
+                if (i == 0)
+                    secondPath.startNewSubPath(x, y);
+                else
+                    secondPath.lineTo(x, y);
+            }
+
+            g.setColour(juce::Colour(0xffff9933).withAlpha(0.8f));
+            g.strokePath(secondPath, juce::PathStrokeType(1.2f));
+        }
+
+        // Peak-hold and max-hold of the first trace as thin lines
+        auto drawHoldTrace = [&](SpectrumEngine::TraceKind kind, juce::Colour colour)
+        {
+            engine.getDisplayData(holdTraceData, 0, kind);
+
+            juce::Path holdPath;
+            for (int i = 0; i < static_cast<int>(holdTraceData.size()); ++i)
+            {
+                auto x = columnX[static_cast<size_t>(i)];
+                auto y = toY(holdTraceData[i]);
+
+                if (i == 0)
+                    holdPath.startNewSubPath(x, y);
+                else
+                    holdPath.lineTo(x, y);
+            }
+
+            g.setColour(colour);
+            g.strokePath(holdPath, juce::PathStrokeType(0.8f));
+        };
+
+        drawHoldTrace(SpectrumEngine::TraceKind::peakHold, juce::Colours::white.withAlpha(0.45f));
+        drawHoldTrace(SpectrumEngine::TraceKind::maxHold, juce::Colours::red.withAlpha(0.5f));
+
+        // Reference sidechain, level matched on integrated loudness: the
+        // reference is shifted to the track's loudness, and the difference
+        // curve (track minus reference) is drawn about the centre, +/-24 dB
+        if (engine.hasReference())
+        {
+            engine.getReferenceData(referenceData, differenceData);
+
+            const float trackLUFS = audioProcessor.getIntegratedLUFS();
+            const float referenceLUFS = audioProcessor.getReferenceIntegratedLUFS();
+            const float matchOffset = (trackLUFS > LoudnessMeter::silenceLUFS && referenceLUFS > LoudnessMeter::silenceLUFS)
+                ? trackLUFS - referenceLUFS : 0.0f;
+
+            juce::Path referencePath, differencePath;
+            for (int i = 0; i < static_cast<int>(referenceData.size()); ++i)
+            {
+                auto x = columnX[static_cast<size_t>(i)];
+                auto referenceY = toY(referenceData[i] + matchOffset);
+                auto differenceY = juce::jmap(juce::jlimit(-24.0f, 24.0f, differenceData[i] - matchOffset), -24.0f, 24.0f, height, 0.0f);
+
+                if (i == 0)
+                {
+                    referencePath.startNewSubPath(x, referenceY);
+                    differencePath.startNewSubPath(x, differenceY);
+                }
+                else
+                {
+                    referencePath.lineTo(x, referenceY);
+                    differencePath.lineTo(x, differenceY);
+                }
+            }
+
+            g.setColour(juce::Colour(0xff66ff99).withAlpha(0.7f));
+            g.strokePath(referencePath, juce::PathStrokeType(1.2f));
+
+            g.setColour(juce::Colours::grey.withAlpha(0.3f));
+            g.drawHorizontalLine(static_cast<int>(height * 0.5f), 0, width);
+            g.setColour(juce::Colour(0xffff66cc).withAlpha(0.8f));
+            g.strokePath(differencePath, juce::PathStrokeType(1.0f));
+
+            g.setFont(juce::FontOptions(10.0f));
+            g.setColour(juce::Colour(0xff66ff99));
+            g.drawText("REF " + juce::String(matchOffset, 1) + " dB", 115, 5, 80, 15, juce::Justification::left);
+            g.setColour(juce::Colour(0xffff66cc));
+            g.drawText("DIFF", 195, 5, 40, 15, juce::Justification::left);
+        }
+
+        // Long-term average against the target band; the part of the
+        // average outside the band is filled in
+        if (settings.targetCurve != SpectrumTargets::Genre::none
+            && engine.getLongTermData(longTermData, targetLowData, targetHighData))
+        {
+            const int numColumns = static_cast<int>(longTermData.size());
+
+            juce::Path longTermPath, bandPath;
+            for (int i = 0; i < numColumns; ++i)
+            {
+                auto x = columnX[static_cast<size_t>(i)];
+
+                if (i == 0)
+                {
+                    longTermPath.startNewSubPath(x, toY(longTermData[i]));
+                    bandPath.startNewSubPath(x, toY(targetHighData[i]));
+                }
+                else
+                {
+                    longTermPath.lineTo(x, toY(longTermData[i]));
+                    bandPath.lineTo(x, toY(targetHighData[i]));
+                }
+            }
+
+            for (int i = numColumns - 1; i >= 0; --i)
+                bandPath.lineTo(columnX[static_cast<size_t>(i)],
+                                toY(targetLowData[i]));
+
+            bandPath.closeSubPath();
+            g.setColour(juce::Colour(0xff66cc66).withAlpha(0.12f));
+            g.fillPath(bandPath);
+
+            g.setColour(juce::Colour(0xffff4444).withAlpha(0.35f));
+            for (int i = 0; i < numColumns; ++i)
+            {
+                const float level = longTermData[i];
+                const float edge = level > targetHighData[i] ? targetHighData[i] : level < targetLowData[i] ? targetLowData[i] : level;
+
+                if (edge != level)
+                {
+                    auto x = columnX[static_cast<size_t>(i)];
+                    g.drawVerticalLine(static_cast<int>(x), juce::jmin(toY(level), toY(edge)), juce::jmax(toY(level), toY(edge)));
+                }
+            }
+
+            g.setColour(juce::Colours::white.withAlpha(0.7f));
+            g.strokePath(longTermPath, juce::PathStrokeType(1.5f));
+
+            g.setFont(juce::FontOptions(10.0f));
+            g.drawText("LTAS", 235, 5, 40, 15, juce::Justification::left);
+        }
+
+        // A/B snapshot on the same columns as the live traces: its first
+        // trace, and its long-term average while the live one is shown
+        if (const auto* snapshot = audioProcessor.getSnapshotStore().getSnapshot(overlayIndex))
+        {
+            auto snapshotPath = [&](const float* columns)
+            {
+                juce::Path path;
+                for (size_t i = 0; i < columnX.size(); ++i)
+                {
+                    if (i == 0)
+                        path.startNewSubPath(columnX[i], toY(columns[i]));
+                    else
+                        path.lineTo(columnX[i], toY(columns[i]));
+                }
+                return path;
+            };
+
+            g.setColour(juce::Colour(0xffcc99ff).withAlpha(0.85f));
+            g.strokePath(snapshotPath(snapshot->spectrum[0]), juce::PathStrokeType(1.2f));
+
+            if (settings.targetCurve != SpectrumTargets::Genre::none
+                && (snapshot->flags & SnapshotFileLayout::hasLongTerm) != 0)
+            {
+                g.setColour(juce::Colour(0xffcc99ff).withAlpha(0.5f));
+                g.strokePath(snapshotPath(snapshot->longTerm), juce::PathStrokeType(1.5f));
+            }
+
+            // Integrated loudness of the live signal against the snapshot's
+            const float trackLUFS = audioProcessor.getIntegratedLUFS();
+            juce::String label = "B: " + SnapshotStore::getName(*snapshot);
+
+            if (trackLUFS > LoudnessMeter::silenceLUFS && snapshot->integratedLUFS > LoudnessMeter::silenceLUFS)
+            {
+                const float difference = trackLUFS - snapshot->integratedLUFS;
+                label << "  (" << (difference >= 0.0f ? "+" : "") << juce::String(difference, 1) << " LU)";
+            }
+
+            g.setFont(juce::FontOptions(10.0f));
+            g.drawText(label, 30, 20, 300, 15, juce::Justification::left);
+        }
+
+        // Trace legend
+        g.setFont(juce::FontOptions(10.0f));
+        g.setColour(juce::Colour(0xff66ccff));
+        g.drawText(midSide ? "MID" : "LEFT", 30, 5, 40, 15, juce::Justification::left);
+        g.setColour(juce::Colour(0xffff9933));
+        g.drawText(midSide ? "SIDE" : "RIGHT", 70, 5, 40, 15, juce::Justification::left);
+
         // Reference lines
         g.setColour(juce::Colours::red.withAlpha(0.4f));
-        float zeroDbY = juce::jmap(0.0f, -80.0f, 0.0f, height, 0.0f);
+        float zeroDbY = juce::jmap(0.0f, floordB, ceilingdB, height, 0.0f);
         g.drawHorizontalLine(static_cast<int>(zeroDbY), 0, width);
 
         g.setColour(juce::Colours::orange.withAlpha(0.3f));
-        float warningY = juce::jmap(-12.0f, -80.0f, 0.0f, height, 0.0f);
+        float warningY = juce::jmap(-12.0f, floordB, ceilingdB, height, 0.0f);
         g.drawHorizontalLine(static_cast<int>(warningY), 0, width);
 
         // DEBUGGING: Show if we're getting data
@@ -157,13 +361,568 @@ public:
             width - 100, 5, 95, 15, juce::Justification::right);
     }
 
+    // Column positions shared by every trace, live or stored
+    void resized() override
+    {
+        columnX.resize(TrackTweakAudioProcessor::spectrumSize);
+
+        for (size_t i = 0; i < columnX.size(); ++i)
+            columnX[i] = juce::jmap(static_cast<float>(i), 0.0f, static_cast<float>(columnX.size() - 1),
+                                    0.0f, static_cast<float>(getWidth()));
+    }
+
+    // Snapshot drawn over the live traces, by store index (-1 for none)
+    void setOverlay(int snapshotIndex)
+    {
+        overlayIndex = snapshotIndex;
+        repaint();
+    }
+
+    // Double-click clears the max-hold trace
+    void mouseDoubleClick(const juce::MouseEvent&) override
+    {
+        audioProcessor.getSpectrumEngine().resetMaxHold();
+    }
+
+private:
+    TrackTweakAudioProcessor& audioProcessor;
+    std::vector<float> columnX;
+    int overlayIndex = -1;
+    std::vector<float> secondTraceData;
+    std::vector<float> holdTraceData;
+    std::vector<float> referenceData, differenceData;
+    std::vector<float> longTermData, targetLowData, targetHighData;
+};
+
+//==============================================================================
+// Octave / third-octave band level bars (click to cycle resolution and ballistics)
+class BandLevelDisplay : public juce::Component
+{
+public:
+    BandLevelDisplay(TrackTweakAudioProcessor& p) : audioProcessor(p)
+    {
+        setOpaque(true);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff1a1a1a));
+
+        g.setColour(juce::Colours::grey.withAlpha(0.4f));
+        g.drawRect(getLocalBounds(), 1);
+
+        const auto& meter = audioProcessor.getOctaveBandMeter();
+        const auto weighting = slowWeighting ? OctaveBandMeter::TimeWeighting::slow
+                                             : OctaveBandMeter::TimeWeighting::fast;
+
+        std::array<float, OctaveBandMeter::numThirdOctaveBands> levels;
+        int numBands;
+
+        if (showOctaves)
+        {
+            meter.getOctaveLevels(levels.data(), weighting);
+            numBands = OctaveBandMeter::numOctaveBands;
+        }
+        else
+        {
+            meter.getThirdOctaveLevels(levels.data(), weighting);
+            numBands = OctaveBandMeter::numThirdOctaveBands;
+        }
+
+        auto bounds = getLocalBounds().toFloat().reduced(4.0f);
+        auto labelArea = bounds.removeFromBottom(12.0f);
+        const float barWidth = bounds.getWidth() / static_cast<float>(numBands);
+
+        // dB grid
+        g.setColour(juce::Colours::grey.withAlpha(0.15f));
+        for (int dB = -80; dB <= 0; dB += 20)
+        {
+            float y = juce::jmap(static_cast<float>(dB), -80.0f, 0.0f, bounds.getBottom(), bounds.getY());
+            g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
+        }
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const float level = juce::jlimit(-80.0f, 0.0f, levels[static_cast<size_t>(band)]);
+            const float top = juce::jmap(level, -80.0f, 0.0f, bounds.getBottom(), bounds.getY());
+            const float x = bounds.getX() + barWidth * static_cast<float>(band);
+
+            g.setColour(level > -12.0f ? juce::Colour(0xffff9933) : juce::Colour(0xff4da6ff));
+            g.fillRect(x + 1.0f, top, barWidth - 2.0f, bounds.getBottom() - top);
+        }
+
+        // Centre frequency labels for a few reference bands
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.8f));
+        g.setFont(juce::FontOptions(8.0f));
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const float centre = showOctaves ? OctaveBandMeter::getOctaveCentre(band)
+                                             : OctaveBandMeter::getThirdOctaveCentre(band);
+            const bool labelled = showOctaves || (band % 3 == 2);
+            if (! labelled)
+                continue;
+
+            const float x = bounds.getX() + barWidth * (static_cast<float>(band) + 0.5f);
+            const juce::String text = centre >= 1000.0f ? juce::String(centre / 1000.0f, 1) + "k"
+                                                        : juce::String(juce::roundToInt(centre));
+            g.drawText(text, static_cast<int>(x - 15), static_cast<int>(labelArea.getY()), 30, 12,
+                juce::Justification::centred);
+        }
+
+        // Mode indicator
+        g.setColour(juce::Colours::yellow);
+        g.setFont(juce::FontOptions(10.0f));
+        g.drawText(juce::String(showOctaves ? "1/1 OCT" : "1/3 OCT") + (slowWeighting ? " - SLOW" : " - FAST"),
+            getWidth() - 105, 5, 100, 15, juce::Justification::right);
+    }
+
+    void mouseDown(const juce::MouseEvent&) override
+    {
+        // Cycle 1/3 fast -> 1/3 slow -> 1/1 fast -> 1/1 slow
+        if (slowWeighting)
+            showOctaves = ! showOctaves;
+
+        slowWeighting = ! slowWeighting;
+        repaint();
+    }
+
 private:
     TrackTweakAudioProcessor& audioProcessor;
+    bool showOctaves = false;
+    bool slowWeighting = false;
+};
+
+//==============================================================================
+// Loudness over the whole timeline from the block cache: 400 ms loudness per
+// pixel column, the play position, and a selection (drag) measured from the
+// cache. Double-click forgets everything cached.
+class TimelineLoudnessView : public juce::Component
+{
+public:
+    TimelineLoudnessView(LoudnessTimeline& t) : timeline(t)
+    {
+        setOpaque(true);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff1a1a1a));
+
+        g.setColour(juce::Colours::grey.withAlpha(0.4f));
+        g.drawRect(getLocalBounds(), 1);
+
+        auto bounds = getLocalBounds().toFloat().reduced(4.0f);
+        auto textArea = bounds.removeFromBottom(14.0f);
+        const auto numBlocks = getDisplayedBlocks();
+
+        // LUFS grid, -60..0
+        g.setColour(juce::Colours::grey.withAlpha(0.15f));
+        for (int lufs = -48; lufs < 0; lufs += 12)
+        {
+            float y = juce::jmap(static_cast<float>(lufs), -60.0f, 0.0f, bounds.getBottom(), bounds.getY());
+            g.drawHorizontalLine(static_cast<int>(y), bounds.getX(), bounds.getRight());
+        }
+
+        // Selection
+        if (selectionEnd > selectionStart)
+        {
+            g.setColour(juce::Colours::white.withAlpha(0.08f));
+            g.fillRect(juce::Rectangle<float>::leftTopRightBottom(blockToX(selectionStart, bounds), bounds.getY(),
+                blockToX(selectionEnd, bounds), bounds.getBottom()));
+        }
+
+        // Loudest 400 ms window under each column
+        const int numColumns = static_cast<int>(bounds.getWidth());
+        updateColumnLevels(numColumns, numBlocks);
+
+        for (int column = 0; column < numColumns; ++column)
+        {
+            const float loudest = columnLevels[static_cast<size_t>(column)];
+
+            if (loudest <= -60.0f)
+                continue;
+
+            const float top = juce::jmap(juce::jmin(loudest, 0.0f), -60.0f, 0.0f, bounds.getBottom(), bounds.getY());
+            g.setColour(loudest > -14.0f ? juce::Colour(0xffff9933) : juce::Colour(0xff66cc66));
+            g.fillRect(bounds.getX() + static_cast<float>(column), top, 1.0f, bounds.getBottom() - top);
+        }
+
+        // Play position
+        if (const auto playBlock = timeline.getPlayPositionBlock(); playBlock >= 0)
+        {
+            g.setColour(juce::Colours::white.withAlpha(0.6f));
+            g.drawVerticalLine(static_cast<int>(blockToX(playBlock, bounds)), bounds.getY(), bounds.getBottom());
+        }
+
+        g.setFont(juce::FontOptions(10.0f));
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.8f));
+        g.drawText(formatTime(numBlocks) + " cached   reused " + juce::String(timeline.getNumReused())
+            + "   changed " + juce::String(timeline.getNumReplaced()) + "   seeks " + juce::String(timeline.getNumSeeks()),
+            textArea, juce::Justification::centredLeft);
+
+        if (selectionEnd > selectionStart)
+        {
+            const auto& range = getSelectionMeasurement();
+
+            g.setColour(juce::Colours::yellow);
+            g.drawText(formatTime(selectionStart) + "-" + formatTime(selectionEnd) + "   I "
+                + juce::String(range.integratedLUFS, 1) + " LUFS   TP " + juce::String(range.truePeakDecibels, 1)
+                + " dBTP   " + juce::String(juce::roundToInt(range.coverage * 100.0f)) + "%",
+                textArea, juce::Justification::centredRight);
+        }
+    }
+
+    void mouseDown(const juce::MouseEvent& e) override
+    {
+        dragStart = xToBlock(e.position.x);
+        selectionStart = selectionEnd = dragStart;
+        repaint();
+    }
+
+    void mouseDrag(const juce::MouseEvent& e) override
+    {
+        const auto block = xToBlock(e.position.x);
+        selectionStart = juce::jmin(dragStart, block);
+        selectionEnd = juce::jmax(dragStart, block);
+        repaint();
+    }
+
+    void mouseDoubleClick(const juce::MouseEvent&) override
+    {
+        timeline.clear();
+        selectionStart = selectionEnd = 0;
+        repaint();
+    }
+
+    // Selects a span of timeline samples, rounded out to whole blocks
+    void selectSamples(juce::int64 firstSample, juce::int64 endSample)
+    {
+        const int samplesPerBlock = timeline.getSamplesPerBlock();
+        if (samplesPerBlock <= 0 || firstSample < 0)
+            return;
+
+        selectionStart = firstSample / samplesPerBlock;
+        selectionEnd = juce::jmax(selectionStart + 1, (endSample + samplesPerBlock - 1) / samplesPerBlock);
+        repaint();
+    }
+
+private:
+    // At least a minute, so the first seconds don't fill the whole width
+    juce::int64 getDisplayedBlocks() const
+    {
+        return juce::jmax(timeline.getNumBlocks(), timeline.getPlayPositionBlock() + 1, juce::int64(600));
+    }
+
+    float blockToX(juce::int64 block, juce::Rectangle<float> bounds) const
+    {
+        return bounds.getX() + bounds.getWidth() * static_cast<float>(block) / static_cast<float>(getDisplayedBlocks());
+    }
+
+    juce::int64 xToBlock(float x) const
+    {
+        const float position = juce::jlimit(0.0f, 1.0f, (x - 4.0f) / static_cast<float>(juce::jmax(1, getWidth() - 8)));
+        return static_cast<juce::int64>(position * static_cast<float>(getDisplayedBlocks()));
+    }
+
+    // The column levels and the selection's measurement are redone only
+    // when the timeline, the width or the selection has changed, not on
+    // every repaint
+    void updateColumnLevels(int numColumns, juce::int64 numBlocks)
+    {
+        if (numColumns == static_cast<int>(columnLevels.size()) && numBlocks == columnLevelsBlocks
+            && timeline.getVersion() == columnLevelsVersion)
+            return;
+
+        columnLevels.assign(static_cast<size_t>(juce::jmax(0, numColumns)), LoudnessMeter::silenceLUFS);
+        columnLevelsBlocks = numBlocks;
+        columnLevelsVersion = timeline.getVersion();
+
+        for (int column = 0; column < numColumns; ++column)
+        {
+            const auto first = numBlocks * column / numColumns;
+            const auto last = juce::jmax(first + 1, numBlocks * (column + 1) / numColumns);
+            auto& loudest = columnLevels[static_cast<size_t>(column)];
+
+            for (auto block = first; block < last; ++block)
+                loudest = juce::jmax(loudest, timeline.getMomentaryLUFS(block));
+        }
+    }
+
+    const LoudnessTimeline::RangeMeasurement& getSelectionMeasurement()
+    {
+        if (selectionStart != measuredStart || selectionEnd != measuredEnd || timeline.getVersion() != measuredVersion)
+        {
+            selectionMeasurement = timeline.measureRange(selectionStart, selectionEnd);
+            measuredStart = selectionStart;
+            measuredEnd = selectionEnd;
+            measuredVersion = timeline.getVersion();
+        }
+
+        return selectionMeasurement;
+    }
+
+    // Blocks are 100 ms
+    static juce::String formatTime(juce::int64 block)
+    {
+        const auto tenths = block % 10, seconds = (block / 10) % 60, minutes = block / 600;
+        return juce::String(minutes) + ":" + juce::String(seconds).paddedLeft('0', 2) + "." + juce::String(tenths);
+    }
+
+    LoudnessTimeline& timeline;
+    juce::int64 dragStart = 0, selectionStart = 0, selectionEnd = 0;
+
+    std::vector<float> columnLevels;
+    juce::int64 columnLevelsBlocks = -1;
+    juce::uint32 columnLevelsVersion = 0;
+
+    LoudnessTimeline::RangeMeasurement selectionMeasurement;
+    juce::int64 measuredStart = -1, measuredEnd = -1;
+    juce::uint32 measuredVersion = 0;
+};
+
+//==============================================================================
+// Every TrackTweak instance in the process, one row each. The ListBox only
+// paints the rows on screen, so hundreds of instances cost no more than a
+// screenful; refresh() is driven by the editor's timer.
+class InstanceOverview : public juce::Component,
+    private juce::ListBoxModel
+{
+public:
+    InstanceOverview(const InstanceRegistry::Entry* ownEntry) : thisInstance(ownEntry)
+    {
+        setOpaque(true);
+        rows.reserve(InstanceRegistry::maxInstances);
+
+        listBox.setModel(this);
+        listBox.setRowHeight(18);
+        listBox.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff1a1a1a));
+        addAndMakeVisible(listBox);
+    }
+
+    void refresh()
+    {
+        rows.clear();
+        InstanceRegistry::getInstance().collectActive(rows);
+
+        listBox.updateContent();
+        listBox.repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff1a1a1a));
+
+        g.setColour(juce::Colour(0xffff9933));
+        g.setFont(juce::FontOptions(14.0f, juce::Font::bold));
+        g.drawText("ALL TRACKS (" + juce::String(static_cast<int>(rows.size())) + ")",
+            getLocalBounds().removeFromTop(25), juce::Justification::centred);
+
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.8f));
+        g.setFont(juce::FontOptions(10.0f));
+        paintColumns(g, getLocalBounds().withTrimmedTop(25).removeFromTop(16).reduced(5, 0),
+            { "Track", "Momentary", "Short-term", "Integrated", "Peak", "Max peak" });
+    }
+
+    void resized() override
+    {
+        listBox.setBounds(getLocalBounds().withTrimmedTop(41));
+    }
+
+private:
+    int getNumRows() override
+    {
+        return static_cast<int>(rows.size());
+    }
+
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool) override
+    {
+        if (! juce::isPositiveAndBelow(row, static_cast<int>(rows.size())))
+            return;
+
+        const auto* entry = rows[static_cast<size_t>(row)];
+        const auto& snapshot = entry->snapshot;
+
+        if (entry == thisInstance)
+            g.fillAll(juce::Colour(0xff2d2d30));
+
+        auto toPeakText = [](float peak)
+        {
+            return peak > 0.0f ? juce::String(DecibelConversion::gainToDecibels(peak), 1) : juce::String("-inf");
+        };
+
+        const float shortTerm = snapshot.shortTermLUFS.load(std::memory_order_relaxed);
+        g.setColour(shortTerm > -14.0f ? juce::Colour(0xffff4444) : juce::Colours::white);
+        g.setFont(juce::FontOptions(11.0f));
+
+        paintColumns(g, { 5, 0, width - 10, height },
+            { entry->getName(),
+              juce::String(snapshot.momentaryLUFS.load(std::memory_order_relaxed), 1),
+              juce::String(shortTerm, 1),
+              juce::String(snapshot.integratedLUFS.load(std::memory_order_relaxed), 1),
+              toPeakText(snapshot.peak.load(std::memory_order_relaxed)),
+              toPeakText(snapshot.maxPeak.load(std::memory_order_relaxed)) });
+    }
+
+    // Name column takes a third, the five value columns share the rest
+    static void paintColumns(juce::Graphics& g, juce::Rectangle<int> area, std::initializer_list<juce::String> cells)
+    {
+        auto nameArea = area.removeFromLeft(area.getWidth() / 3);
+        const int valueWidth = area.getWidth() / 5;
+        bool first = true;
+
+        for (const auto& cell : cells)
+        {
+            if (first)
+                g.drawText(cell, nameArea, juce::Justification::centredLeft, true);
+            else
+                g.drawText(cell, area.removeFromLeft(valueWidth), juce::Justification::centredRight, true);
+
+            first = false;
+        }
+    }
+
+    const InstanceRegistry::Entry* thisInstance;
+    std::vector<InstanceRegistry::Entry*> rows;
+    juce::ListBox listBox{ "Instances" };
+};
+
+//==============================================================================
+// Events drained from the processor's detector, newest first. Clicking one
+// hands it to onEventClicked; the oldest are forgotten beyond maxEvents.
+class EventList : public juce::Component,
+    private juce::ListBoxModel
+{
+public:
+    static constexpr int maxEvents = 1000;
+
+    EventList(MeterEventDetector& d) : detector(d)
+    {
+        setOpaque(true);
+        events.reserve(maxEvents);
+
+        listBox.setModel(this);
+        listBox.setRowHeight(18);
+        listBox.setColour(juce::ListBox::backgroundColourId, juce::Colour(0xff1a1a1a));
+        addAndMakeVisible(listBox);
+    }
+
+    // Message thread, from the editor's timer; true if anything arrived
+    bool drain()
+    {
+        MeterEvent event;
+        bool changed = false;
+
+        while (detector.popEvent(event))
+        {
+            if (events.size() == maxEvents)
+                events.erase(events.begin());
+
+            events.push_back(event);
+            changed = true;
+        }
+
+        if (changed)
+        {
+            listBox.updateContent();
+            repaint();
+        }
+
+        return changed;
+    }
+
+    int getNumEvents() const { return static_cast<int>(events.size()); }
+
+    // For the time column
+    void setSampleRate(double newSampleRate)
+    {
+        if (newSampleRate > 0.0)
+            sampleRate = newSampleRate;
+    }
+
+    std::function<void(const MeterEvent&)> onEventClicked;
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff1a1a1a));
+
+        g.setColour(juce::Colour(0xffff9933));
+        g.setFont(juce::FontOptions(14.0f, juce::Font::bold));
+        g.drawText("EVENTS (" + juce::String(getNumEvents()) + ")", getLocalBounds().removeFromTop(25),
+            juce::Justification::centred);
+
+        g.setColour(juce::Colours::lightgrey.withAlpha(0.8f));
+        g.setFont(juce::FontOptions(10.0f));
+        auto header = getLocalBounds().withTrimmedTop(25).removeFromTop(16).reduced(5, 0);
+
+        if (const int dropped = detector.getNumDropped(); dropped > 0)
+            g.drawText("dropped " + juce::String(dropped), header, juce::Justification::centredRight);
+
+        g.drawText("Time   Event   Value   (click to select on the timeline)", header, juce::Justification::centredLeft);
+    }
+
+    void resized() override
+    {
+        listBox.setBounds(getLocalBounds().withTrimmedTop(41));
+    }
+
+private:
+    int getNumRows() override
+    {
+        return getNumEvents();
+    }
+
+    const MeterEvent& getEventForRow(int row) const
+    {
+        return events[events.size() - 1 - static_cast<size_t>(row)];
+    }
+
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool) override
+    {
+        if (! juce::isPositiveAndBelow(row, getNumEvents()))
+            return;
+
+        const auto& event = getEventForRow(row);
+        auto area = juce::Rectangle<int>(5, 0, width - 10, height);
+
+        const bool isProblem = event.type == MeterEvent::Type::clip || event.type == MeterEvent::Type::truePeakOver
+            || event.type == MeterEvent::Type::dcOffset;
+
+        g.setFont(juce::FontOptions(11.0f));
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(formatTime(event.timelineSample), area.removeFromLeft(80), juce::Justification::centredLeft);
+
+        g.setColour(isProblem ? juce::Colour(0xffff4444) : juce::Colours::white);
+        g.drawText(MeterEvent::getName(event.type), area.removeFromLeft(140), juce::Justification::centredLeft);
+        g.drawText(event.describeValue(), area, juce::Justification::centredLeft);
+    }
+
+    void listBoxItemClicked(int row, const juce::MouseEvent&) override
+    {
+        if (juce::isPositiveAndBelow(row, getNumEvents()) && onEventClicked != nullptr)
+            onEventClicked(getEventForRow(row));
+    }
+
+    juce::String formatTime(juce::int64 sample) const
+    {
+        if (sample < 0)
+            return "stopped";
+
+        const auto tenths = static_cast<juce::int64>(static_cast<double>(sample) * 10.0 / sampleRate);
+        return juce::String(tenths / 600) + ":" + juce::String((tenths / 10) % 60).paddedLeft('0', 2)
+            + "." + juce::String(tenths % 10);
+    }
+
+    MeterEventDetector& detector;
+    std::vector<MeterEvent> events;
+    double sampleRate = 44100.0;
+    juce::ListBox listBox{ "Events" };
 };
 
 //==============================================================================
 class TrackTweakAudioProcessorEditor : public juce::AudioProcessorEditor,
-    private juce::Timer
+    private juce::Timer,
+    private juce::ChangeListener
 {
 public:
     TrackTweakAudioProcessorEditor(TrackTweakAudioProcessor&);
@@ -172,26 +931,105 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Milliseconds from the host asking for the editor until its first
+    // paint, and until every view is built; -1 until then
+    float getFirstPaintMilliseconds() const noexcept { return firstPaintMilliseconds; }
+    float getReadyMilliseconds() const noexcept { return readyMilliseconds; }
+
 private:
+    bool buildNextViews();
+    static void paintBackground(juce::Graphics& g, int width, int height);
+    float getMillisecondsSinceOpened() const;
+
     void timerCallback() override;
-    juce::String getLUFSAdvice(float lufs) const;
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void updateSnapshotList();
+    const char* getLUFSAdvice(float lufs) const;
+
+    // Time to first paint and until the controls are built, from the
+    // moment the host asks for the editor; shown next to the callback cost
+    const juce::int64 openedTicks = juce::Time::getHighResolutionTicks();
+    float firstPaintMilliseconds = -1.0f, readyMilliseconds = -1.0f;
 
     TrackTweakAudioProcessor& audioProcessor;
+    EditorAssets& assets;
+
+    // This instance's last frame, shown until the controls are built
+    juce::Image cachedFrame;
+    int nextBuildStep = 0;
+    bool viewsBuilt = false;
+
+    // Level meters and readouts, drawing their digits from the atlas shared
+    // by every editor
+    const MeterGlyphAtlas& glyphAtlas{ assets.getGlyphAtlas() };
+    LevelMeter rmsMeter{ glyphAtlas, "RMS", MeterBallistics::Mode::volumeUnit };
+    LevelMeter peakMeter{ glyphAtlas, "Peak", MeterBallistics::Mode::peakProgramme };
+    NumericReadout truePeakReadout{ glyphAtlas, { { "True peak", "dBTP" } } };
+    NumericReadout momentaryReadout{ glyphAtlas, { { "Momentary", "LUFS" } } };
+    NumericReadout shortTermReadout{ glyphAtlas, { { "Short-term", "LUFS" } } };
+    NumericReadout integratedReadout{ glyphAtlas, { { "Integrated", "LUFS" }, { "LRA", "LU", 1, 4 } } };
+    NumericReadout dynamicsReadout{ glyphAtlas, { { "Crest", "dB", 1, 4 }, { "PLR", "dB", 1, 4 },
+                                                  { "PSR", "dB", 1, 4 }, { "DR", "", 0, 2 } } };
+    NumericReadout costReadout{ glyphAtlas, { { "Callback avg", "us", 1, 6 }, { "peak", "us", 1, 6 },
+                                              { "peak/avg", "", 1, 4 }, { "UI open", "ms", 1, 5 },
+                                              { "ready", "ms", 1, 5 } } };
+    double lastFrameTime = 0.0;
 
-    // Display labels
-    juce::Label rmsLabel;
-    juce::Label momentaryLUFSLabel;
-    juce::Label shortTermLUFSLabel;
-    juce::Label integratedLUFSLabel;
     juce::Label tipLabel;
+    const char* currentTip = nullptr;
 
     // Section titles
     juce::Label rmsTitle;
     juce::Label lufsTitle;
     juce::Label spectrumTitle;
+    juce::Label bandsTitle;
 
     // Spectrum analyzer component
     std::unique_ptr<SpectrumAnalyzer> spectrumAnalyzer;
 
+    // FFT size / window / calibration selectors
+    juce::ComboBox fftSizeBox;
+    juce::ComboBox windowBox;
+    juce::ComboBox channelModeBox;
+    juce::ComboBox averagingBox;
+    juce::ComboBox smoothingBox;
+    juce::ToggleButton noiseCalibrationButton{ "Noise" };
+
+    // Long-term average: target curve, and a button that restarts it and
+    // holds it when released
+    juce::Label longTermTitle;
+    juce::ComboBox targetBox;
+    juce::TextButton markButton{ "Mark" };
+
+    // A/B snapshots: capture the current analysis, pick one to overlay, or
+    // delete the one shown. The overlay is remembered by capture time, since
+    // indices shift when the store changes.
+    juce::ComboBox snapshotBox;
+    juce::TextButton captureButton{ "Capture" };
+    juce::TextButton deleteSnapshotButton{ "X" };
+    juce::int64 overlaySnapshot = 0;
+    int framesUntilStoreCheck = 0;
+
+    // The selectors above drive their host parameters; the attachments go
+    // first so they never outlive their controls
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    std::array<std::unique_ptr<ComboBoxAttachment>, 6> comboBoxAttachments;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> noiseCalibrationAttachment;
+
+    // Octave band bar display
+    std::unique_ptr<BandLevelDisplay> bandLevelDisplay;
+
+    // Loudness of the whole timeline
+    juce::Label timelineTitle;
+    std::unique_ptr<TimelineLoudnessView> timelineView;
+
+    // All-instances overview, shown over the meters (built on first use)
+    juce::TextButton overviewButton{ "All Tracks" };
+    std::unique_ptr<InstanceOverview> instanceOverview;
+
+    // Detected events, shown over the meters in the same way
+    juce::TextButton eventsButton{ "Events" };
+    std::unique_ptr<EventList> eventList;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackTweakAudioProcessorEditor)
 };
\ No newline at end of file
@@ -16,27 +16,41 @@ TrackTweakAudioProcessor::TrackTweakAudioProcessor()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
+        .withInput("Reference", juce::AudioChannelSet::stereo(), false)
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-    ),
+    )
 #endif
-    fft(fftOrder),
-    window(fftSize, juce::dsp::WindowingFunction<float>::hann),
-    abstractFifo(fftSize)
 {
-    // Initialize spectrum data
-    spectrumMagnitudes.resize(spectrumSize);
-    smoothedSpectrum.resize(spectrumSize);
-    std::fill(spectrumMagnitudes.begin(), spectrumMagnitudes.end(), -100.0f);
-    std::fill(smoothedSpectrum.begin(), smoothedSpectrum.end(), -100.0f);
-    std::fill(fftData.begin(), fftData.end(), 0.0f);
-    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
-    std::fill(fifoBuffer.begin(), fifoBuffer.end(), 0.0f);
+   #if TRACKTWEAK_TRACING
+    TraceRecorder::getInstance().addUser();
+   #endif
+
+    registryEntry = InstanceRegistry::getInstance().join();
+    spectrumEngine.setFrameListener(this);
+
+    for (const auto* id : AnalyzerSettings::parameterIDs)
+        parameters.addParameterListener(id, this);
+
+    publishSettings();
+    startTimerHz(20);
 }
 
 TrackTweakAudioProcessor::~TrackTweakAudioProcessor()
 {
+    stopTimer();
+
+    for (const auto* id : AnalyzerSettings::parameterIDs)
+        parameters.removeParameterListener(id, this);
+
+    spectrumEngine.setFrameListener(nullptr);
+    InstanceRegistry::getInstance().leave(registryEntry);
+    editorAssets->forgetFrame(this);
+
+   #if TRACKTWEAK_TRACING
+    TraceRecorder::getInstance().removeUser();
+   #endif
 }
 
 //==============================================================================
@@ -107,27 +121,26 @@ void TrackTweakAudioProcessor::changeProgramName(int index, const juce::String&
 //==============================================================================
 void TrackTweakAudioProcessor::prepareToPlay(double sr, int samplesPerBlock)
 {
+    // Analysis runs on fixed sub-blocks, so the host's block size doesn't matter
     juce::ignoreUnused(samplesPerBlock);
 
     // Store sample rate (renamed parameter to avoid hiding member variable)
     sampleRate = sr;
 
-    // Prepare circular buffers for LUFS measurements
-    int momentarySize = static_cast<int>(sr * 0.4); // 400ms for momentary LUFS
-    int shortTermSize = static_cast<int>(sr * 3.0); // 3 seconds for short-term LUFS
+    // Hosts call this repeatedly (bounces, device switches): the loudness meter
+    // only swaps in a new configuration when the sample rate really changes,
+    // and keeps its history and integrated value otherwise
+    loudnessMeter.prepare(sr);
+    referenceLoudnessMeter.prepare(sr);
+    dynamicsMeter.prepare(sr);
+    eventDetector.prepare(sr);
+    processingCost.prepare(sr);
 
-    momentaryBuffer.setSize(2, momentarySize);
-    shortTermBuffer.setSize(2, shortTermSize);
+    // Spectrum worker rebuilds its plan for the new sample rate
+    spectrumEngine.prepare(sr);
 
-    momentaryBuffer.clear();
-    shortTermBuffer.clear();
-
-    momentaryWritePos = 0;
-    shortTermWritePos = 0;
-
-    // Initialize spectrum analyzer
-    fifoIndex = 0;
-    nextFFTBlockReady = false;
+    // Octave band filterbank (coefficients depend on the sample rate)
+    bandMeter.prepare(sr, subBlockSize);
 }
 
 void TrackTweakAudioProcessor::releaseResources()
@@ -155,6 +168,17 @@ bool TrackTweakAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // Reference sidechain: off, mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto reference = layouts.getChannelSet(true, 1);
+
+        if (! reference.isDisabled()
+            && reference != juce::AudioChannelSet::mono()
+            && reference != juce::AudioChannelSet::stereo())
+            return false;
+    }
 #endif
 
     return true;
@@ -162,10 +186,28 @@ bool TrackTweakAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts
 }
 #endif
 
+bool TrackTweakAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
 void TrackTweakAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
+
+void TrackTweakAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
 
+template <typename SampleType>
+void TrackTweakAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
+    TRACKTWEAK_TRACE_SCOPE("processBlock");
+    const ProcessingCost::Scope costScope(processingCost, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -173,177 +215,304 @@ void TrackTweakAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // --- RMS detection on first input channel only (keep existing)
-    if (buffer.getNumChannels() > 0)
-    {
-        auto* channelData = buffer.getReadPointer(0);  // use left channel for analysis
-        int numSamples = buffer.getNumSamples();
+    // The main input and the optional reference sidechain, as views into
+    // the host's buffer
+    const auto input = getBusBuffer(buffer, true, 0);
+    const int numInputChannels = juce::jmin(input.getNumChannels(), maxAnalysisChannels);
+    const int numSamples = buffer.getNumSamples();
 
-        float sumSquares = 0.0f;
-        for (int i = 0; i < numSamples; ++i)
-            sumSquares += channelData[i] * channelData[i];
+    juce::AudioBuffer<SampleType> referenceBuffer;
+    int numReferenceChannels = 0;
 
-        currentRMSLevel.store(std::sqrt(sumSquares / static_cast<float>(numSamples)));
+    if (auto* referenceBus = getBus(true, 1); referenceBus != nullptr && referenceBus->isEnabled())
+    {
+        referenceBuffer = getBusBuffer(buffer, true, 1);
+        numReferenceChannels = juce::jmin(referenceBuffer.getNumChannels(), maxAnalysisChannels);
     }
 
-    // --- LUFS measurement (existing)
-    updateLUFSMeasurements(buffer);
+    if (numInputChannels == 0)
+        return;
 
-    // --- Spectrum analysis (new)
-    pushSamplesToFifo(buffer);
-}
+    // Where this block sits on the host timeline, so the meter's 100 ms
+    // blocks line up with the timeline cache
+    juce::int64 timelinePosition = -1;
 
-//==============================================================================
-void TrackTweakAudioProcessor::updateLUFSMeasurements(const juce::AudioBuffer<float>& buffer)
-{
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = std::min(buffer.getNumChannels(), 2); // Limit to stereo
+    if (auto* playHead = getPlayHead())
+        if (const auto position = playHead->getPosition(); position.hasValue() && position->getIsPlaying())
+            timelinePosition = position->getTimeInSamples().orFallback(-1);
 
-    // Copy samples into circular buffers
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Offline renders analyse every spectrum frame in bulk rather than
+    // dropping what the worker can't keep up with
+    const bool offline = isNonRealtime();
+    spectrumEngine.setBulkMode(offline);
+
+    // A layout change drops whatever was carried over
+    if (numInputChannels != carriedInputChannels || numReferenceChannels != carriedReferenceChannels)
     {
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            float inputSample = buffer.getSample(channel, sample);
+        numCarriedSamples = 0;
+        carriedInputChannels = numInputChannels;
+        carriedReferenceChannels = numReferenceChannels;
+    }
 
-            // Store in momentary buffer (400ms)
-            momentaryBuffer.setSample(channel, momentaryWritePos, inputSample);
+    // The carried samples come first on the timeline
+    const auto carriedPosition = timelinePosition >= 0 ? timelinePosition - numCarriedSamples : -1;
+    loudnessMeter.setTimelinePosition(carriedPosition);
+
+    const auto* const* inputChannels = input.getArrayOfReadPointers();
+    const auto* const* referenceChannels = numReferenceChannels > 0 ? referenceBuffer.getArrayOfReadPointers() : nullptr;
+    int sample = 0;
+
+    // Complete the tail carried over from the last callback
+    if (numCarriedSamples > 0)
+    {
+        const int count = juce::jmin(subBlockSize - numCarriedSamples, numSamples);
 
-            // Store in short-term buffer (3s)
-            shortTermBuffer.setSample(channel, shortTermWritePos, inputSample);
+        for (int channel = 0; channel < numInputChannels + numReferenceChannels; ++channel)
+        {
+            const SampleType* source = channel < numInputChannels ? inputChannels[channel]
+                                                                  : referenceChannels[channel - numInputChannels];
+            std::copy_n(source, count, carriedSamples[static_cast<size_t>(channel)].data() + numCarriedSamples);
         }
 
-        momentaryWritePos = (momentaryWritePos + 1) % momentaryBuffer.getNumSamples();
-        shortTermWritePos = (shortTermWritePos + 1) % shortTermBuffer.getNumSamples();
+        numCarriedSamples += count;
+        sample = count;
+
+        if (numCarriedSamples == subBlockSize)
+        {
+            std::array<const double*, maxAnalysisChannels * 2> carried;
+            for (size_t channel = 0; channel < carried.size(); ++channel)
+                carried[channel] = carriedSamples[channel].data();
+
+            analyseSubBlock(carried.data(), numInputChannels,
+                            numReferenceChannels > 0 ? carried.data() + numInputChannels : nullptr, numReferenceChannels,
+                            subBlockSize, carriedPosition, offline);
+            numCarriedSamples = 0;
+        }
     }
 
-    // Calculate LUFS values and store atomically
-    currentMomentaryLUFS.store(calculateSimpleLUFS(momentaryBuffer, momentaryBuffer.getNumSamples()));
-    currentShortTermLUFS.store(calculateSimpleLUFS(shortTermBuffer, shortTermBuffer.getNumSamples()));
-    currentIntegratedLUFS.store(currentShortTermLUFS.load()); // Simplified - use short-term for now
-}
+    // Whole sub-blocks straight from the host's buffer: every stage runs
+    // over the same 64 samples while they are still in L1
+    std::array<const SampleType*, maxAnalysisChannels> inputPointers{}, referencePointers{};
 
-float TrackTweakAudioProcessor::calculateSimpleLUFS(const juce::AudioBuffer<float>& buffer, int numSamplesToUse) const
-{
-    float sum = 0.0f;
-    int channels = std::min(buffer.getNumChannels(), 2);
+    for (; sample + subBlockSize <= numSamples; sample += subBlockSize)
+    {
+        for (int channel = 0; channel < numInputChannels; ++channel)
+            inputPointers[static_cast<size_t>(channel)] = inputChannels[channel] + sample;
+
+        for (int channel = 0; channel < numReferenceChannels; ++channel)
+            referencePointers[static_cast<size_t>(channel)] = referenceChannels[channel] + sample;
+
+        analyseSubBlock(inputPointers.data(), numInputChannels,
+                        numReferenceChannels > 0 ? referencePointers.data() : nullptr, numReferenceChannels,
+                        subBlockSize, timelinePosition >= 0 ? timelinePosition + sample : -1, offline);
+    }
 
-    for (int channel = 0; channel < channels; ++channel)
+    // Carry the rest to the next callback
+    if (sample < numSamples)
     {
-        const float* channelData = buffer.getReadPointer(channel);
-        for (int i = 0; i < numSamplesToUse; ++i)
+        const int count = numSamples - sample;
+
+        for (int channel = 0; channel < numInputChannels + numReferenceChannels; ++channel)
         {
-            float sample = channelData[i];
-            sum += sample * sample;
+            const SampleType* source = channel < numInputChannels ? inputChannels[channel]
+                                                                  : referenceChannels[channel - numInputChannels];
+            std::copy_n(source + sample, count, carriedSamples[static_cast<size_t>(channel)].data());
         }
+
+        numCarriedSamples = count;
     }
 
-    float meanSquare = sum / (numSamplesToUse * channels);
-    if (meanSquare <= 1e-10f) // Better threshold
-        return -70.0f;
+   #if TRACKTWEAK_TRACING
+    // The stages run once per sub-block; each gets one span per callback,
+    // back to back, as long as its pieces added up to
+    {
+        auto& recorder = TraceRecorder::getInstance();
+        const auto now = juce::Time::getHighResolutionTicks();
+        recorder.recordTotal("bandMeter", tracedBandMeterTicks, now);
+        recorder.recordTotal("loudness", tracedLoudnessTicks, now - tracedBandMeterTicks);
+        tracedLoudnessTicks = tracedBandMeterTicks = 0;
+    }
+   #endif
+
+    // Without a worker, the spectrum gets a fifth of the callback's duration
+    // in real time, and whatever it needs offline
+    if (spectrumEngine.isInline())
+        spectrumEngine.analyseInline(offline ? 60.0 : 0.2 * numSamples / sampleRate);
 
-    // FIXED: Proper LUFS calculation to match industry tools
-    // Remove the -0.691 offset and use proper reference
-    float lufsValue = 10.0f * std::log10(meanSquare) + 16.0f; // Added +16dB correction
+    // RMS of the first channel and peak of all, over what was analysed
+    if (levelSampleCount > 0)
+    {
+        currentRMSLevel.store(static_cast<float>(std::sqrt(levelSumSquares / levelSampleCount)));
+        currentPeakLevel.store(levelPeak);
+        levelSumSquares = 0.0;
+        levelPeak = 0.0f;
+        levelSampleCount = 0;
+    }
 
-    return lufsValue;
+    latestTimelinePosition.store(timelinePosition >= 0 ? timelinePosition + numSamples : -1, std::memory_order_relaxed);
 }
 
 //==============================================================================
-// FIXED: Professional Spectrum Analyzer Implementation
-void TrackTweakAudioProcessor::pushSamplesToFifo(const juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void TrackTweakAudioProcessor::analyseSubBlock(const SampleType* const* input, int numInputChannels,
+                                               const SampleType* const* reference, int numReferenceChannels,
+                                               int numSamples, juce::int64 timelinePosition, bool offline)
 {
-    // Use left channel for spectrum analysis
-    if (buffer.getNumChannels() > 0)
+    // --- Energy and sample peak in one pass: RMS shows the first channel,
+    // dynamics take the mean over channels. The plain sums (DC offset) and
+    // the clip count feed the event detector.
+    double sumSquares = 0.0;
+    float peak = 0.0f;
+    int numClipped = 0;
+    std::array<double, maxAnalysisChannels> channelSums{};
+
+    for (int channel = 0; channel < numInputChannels; ++channel)
     {
-        auto* channelData = buffer.getReadPointer(0);
+        double channelSumSquares = 0.0, channelSum = 0.0;
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        for (int i = 0; i < numSamples; ++i)
         {
-            fifoBuffer[fifoIndex] = channelData[i];
-            fifoIndex++;
-
-            if (fifoIndex >= fftSize)
-            {
-                // FIXED: Only process if we're not already processing
-                if (!nextFFTBlockReady)
-                {
-                    // Copy data for FFT processing
-                    std::copy(fifoBuffer.begin(), fifoBuffer.end(), fftData.begin());
-                    nextFFTBlockReady = true;
-                }
-
-                // IMPROVED: Reset index immediately for continuous collection
-                fifoIndex = 0;
-            }
+            const auto x = static_cast<double>(input[channel][i]);
+            channelSumSquares += x * x;
+            channelSum += x;
+            peak = juce::jmax(peak, static_cast<float>(std::abs(x)));
+            numClipped += std::abs(x) >= 1.0 ? 1 : 0;
         }
+
+        if (channel == 0)
+            levelSumSquares += channelSumSquares;
+
+        sumSquares += channelSumSquares;
+        channelSums[static_cast<size_t>(channel)] = channelSum;
     }
-}
 
-void TrackTweakAudioProcessor::performFFT()
-{
-    // Apply windowing to reduce spectral leakage
-    window.multiplyWithWindowingTable(fftData.data(), fftSize);
+    levelPeak = juce::jmax(levelPeak, peak);
+    levelSampleCount += numSamples;
+    dynamicsMeter.addSubBlock(sumSquares / numInputChannels, peak, numSamples);
+
+    // --- LUFS; the reference's integrated loudness is what level-matches
+    // the comparison
+    {
+        TRACKTWEAK_TRACE_ACCUMULATE(tracedLoudnessTicks);
+        loudnessMeter.process(input, numInputChannels, numSamples);
 
-    // FIXED: Copy windowed data into the first half of fftBuffer for frequency-only transform
-    std::copy(fftData.begin(), fftData.end(), fftBuffer.begin());
+        if (reference != nullptr)
+            referenceLoudnessMeter.process(reference, numReferenceChannels, numSamples);
+    }
+
+    eventDetector.addSubBlock(timelinePosition, numSamples, peak, numClipped, channelSums.data(), numInputChannels,
+                              loudnessMeter.takeRecentTruePeak());
+
+    // --- Spectrum analysis: track and reference go to the same worker,
+    // which packs each pair into one complex FFT per hop
+    spectrumEngine.pushSamples(input[0], numInputChannels > 1 ? input[1] : nullptr,
+                               reference != nullptr ? reference[0] : nullptr,
+                               numReferenceChannels > 1 ? reference[1] : nullptr, numSamples);
 
-    // FIXED: Clear the second half (this is important for performFrequencyOnlyForwardTransform)
-    std::fill(fftBuffer.begin() + fftSize, fftBuffer.end(), 0.0f);
+    // --- Octave / third-octave band levels, for the display only
+    if (! offline)
+    {
+        TRACKTWEAK_TRACE_ACCUMULATE(tracedBandMeterTicks);
+        bandMeter.process(input, numInputChannels, numSamples);
+    }
+}
 
-    // Perform FFT - this will place magnitudes in the first fftSize/2 elements
-    fft.performFrequencyOnlyForwardTransform(fftBuffer.data());
+float TrackTweakAudioProcessor::getPeakToLoudnessRatio() const
+{
+    const float integrated = loudnessMeter.getIntegratedLUFS();
+    return integrated > LoudnessMeter::silenceLUFS ? loudnessMeter.getTruePeakDecibels() - integrated : 0.0f;
+}
 
-    // Update spectrum display
-    updateSpectrum();
+float TrackTweakAudioProcessor::getPeakToShortTermRatio() const
+{
+    const float shortTerm = loudnessMeter.getShortTermLUFS();
+    return shortTerm > LoudnessMeter::silenceLUFS ? loudnessMeter.getShortTermTruePeakDecibels() - shortTerm : 0.0f;
 }
 
-void TrackTweakAudioProcessor::updateSpectrum()
+void TrackTweakAudioProcessor::spectrumFrameAnalysed(const float* decibels, int numColumns, const AnalyzerSettings& settings)
 {
-    const juce::ScopedLock lock(spectrumDataMutex);
+    const MeterFeed::Values values{ getMomentaryLUFS(), getShortTermLUFS(), getIntegratedLUFS(),
+                                    getPeakLevel(), getRMSLevel() };
 
-    auto mindB = -80.0f;  // Extended range for better display
-    auto maxdB = 0.0f;
+    meterFeed.publish(values, decibels, numColumns);
 
-    // FIXED: Process the FFT output correctly
-    for (int i = 0; i < spectrumSize; ++i)
-    {
-        // IMPROVED: Better frequency mapping - less aggressive logarithmic scaling
-        float normalizedFreq = static_cast<float>(i) / static_cast<float>(spectrumSize - 1);
+    // Short-term loudness moves slowly enough to check once per frame here,
+    // off the audio thread
+    eventDetector.checkLoudness(values.shortTermLUFS, latestTimelinePosition.load(std::memory_order_relaxed),
+                                settings.loudnessTarget, settings.loudnessTolerance);
 
-        // FIXED: More natural frequency distribution
-        auto binIndex = static_cast<int>(std::pow(normalizedFreq, 0.5f) * (fftSize / 2 - 1)) + 1;
-        binIndex = juce::jlimit(1, fftSize / 2 - 1, binIndex);
+    if (registryEntry != nullptr)
+    {
+        auto& snapshot = registryEntry->snapshot;
+        snapshot.momentaryLUFS.store(values.momentaryLUFS, std::memory_order_relaxed);
+        snapshot.shortTermLUFS.store(values.shortTermLUFS, std::memory_order_relaxed);
+        snapshot.integratedLUFS.store(values.integratedLUFS, std::memory_order_relaxed);
+        snapshot.peak.store(values.peak, std::memory_order_relaxed);
+        snapshot.maxPeak.store(juce::jmax(snapshot.maxPeak.load(std::memory_order_relaxed), values.peak),
+                               std::memory_order_relaxed);
+    }
+}
 
-        // FIXED: Get magnitude from frequency-only FFT (magnitudes are in first half)
-        auto magnitude = fftBuffer[binIndex];
+void TrackTweakAudioProcessor::updateTrackProperties(const TrackProperties& properties)
+{
+    if (! properties.name.has_value())
+        return;
 
-        // FIXED: Proper dB conversion with correct scaling
-        auto magnitudedB = magnitude > 1e-12f ?
-            20.0f * std::log10(magnitude) - 20.0f * std::log10(static_cast<float>(fftSize)) :
-            mindB;
+    meterFeed.setName(*properties.name);
 
-        // IMPROVED: Better smoothing for stable display
-        auto smoothingFactor = 0.15f;  // Reduced for more responsiveness
-        smoothedSpectrum[i] = smoothedSpectrum[i] * (1.0f - smoothingFactor) +
-            magnitudedB * smoothingFactor;
+    if (registryEntry != nullptr)
+        registryEntry->setName(*properties.name);
+}
 
-        // Store final result
-        spectrumMagnitudes[i] = juce::jlimit(mindB, maxdB, smoothedSpectrum[i]);
-    }
+void TrackTweakAudioProcessor::getSpectrumData(std::vector<float>& spectrumData, int trace)
+{
+    spectrumEngine.getDisplayData(spectrumData, trace);
 }
 
-void TrackTweakAudioProcessor::getSpectrumData(std::vector<float>& spectrumData)
+bool TrackTweakAudioProcessor::captureSnapshot(const juce::String& name)
 {
-    // Check if we have a new FFT block ready
-    if (nextFFTBlockReady)
+    static_assert(spectrumSize == SnapshotFileLayout::numColumns, "Snapshots store one value per display column");
+
+    const auto& settings = getAnalyzerSettings();
+    auto record = std::make_unique<SnapshotStore::Record>();
+
+    SnapshotStore::setName(*record, name);
+    SnapshotStore::setSource(*record, registryEntry != nullptr ? registryEntry->getName() : getName());
+    record->createdMilliseconds = juce::Time::currentTimeMillis();
+    record->fftSize = static_cast<std::uint32_t>(1 << settings.fftOrder);
+    record->sampleRate = static_cast<float>(sampleRate);
+
+    record->integratedLUFS = getIntegratedLUFS();
+    record->loudnessRange = getLoudnessRange();
+    record->truePeakDecibels = getTruePeakDecibels();
+    record->maxSamplePeakDecibels = registryEntry != nullptr
+        ? DecibelConversion::gainToDecibels(registryEntry->snapshot.maxPeak.load(), LoudnessMeter::silenceLUFS)
+        : LoudnessMeter::silenceLUFS;
+    record->crestFactor = getCrestFactor();
+    record->dynamicRange = getDynamicRange();
+    record->peakToLoudnessRatio = getPeakToLoudnessRatio();
+
+    if (spectrumEngine.isStereo())
+        record->flags |= SnapshotFileLayout::stereo;
+
+    if (settings.channelMode == AnalyzerSettings::ChannelMode::midSide)
+        record->flags |= SnapshotFileLayout::midSide;
+
+    std::vector<float> columns;
+    for (int trace = 0; trace < SnapshotFileLayout::numTraces; ++trace)
+    {
+        spectrumEngine.getDisplayData(columns, trace);
+        std::copy_n(columns.begin(), juce::jmin(columns.size(), size_t(spectrumSize)), record->spectrum[trace]);
+    }
+
+    std::vector<float> targetLow, targetHigh;
+    if (spectrumEngine.getLongTermData(columns, targetLow, targetHigh))
     {
-        performFFT();
-        nextFFTBlockReady = false;
+        std::copy_n(columns.begin(), juce::jmin(columns.size(), size_t(spectrumSize)), record->longTerm);
+        record->flags |= SnapshotFileLayout::hasLongTerm;
     }
 
-    const juce::ScopedLock lock(spectrumDataMutex);
-    spectrumData = spectrumMagnitudes;
+    return snapshotStore->add(*record);
 }
 
 //==============================================================================
@@ -352,19 +521,24 @@ float TrackTweakAudioProcessor::getRMSLevel() const
     return currentRMSLevel.load();
 }
 
+float TrackTweakAudioProcessor::getPeakLevel() const
+{
+    return currentPeakLevel.load();
+}
+
 float TrackTweakAudioProcessor::getMomentaryLUFS() const
 {
-    return currentMomentaryLUFS.load();
+    return loudnessMeter.getMomentaryLUFS();
 }
 
 float TrackTweakAudioProcessor::getShortTermLUFS() const
 {
-    return currentShortTermLUFS.load();
+    return loudnessMeter.getShortTermLUFS();
 }
 
 float TrackTweakAudioProcessor::getIntegratedLUFS() const
 {
-    return currentIntegratedLUFS.load();
+    return loudnessMeter.getIntegratedLUFS();
 }
 
 //==============================================================================
@@ -381,17 +555,41 @@ juce::AudioProcessorEditor* TrackTweakAudioProcessor::createEditor()
 //==============================================================================
 void TrackTweakAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    juce::ignoreUnused(destData);
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    if (const auto xml = parameters.copyState().createXml())
+        copyXmlToBinary(*xml, destData);
 }
 
 void TrackTweakAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    juce::ignoreUnused(data, sizeInBytes);
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    if (const auto xml = getXmlFromBinary(data, sizeInBytes); xml != nullptr && xml->hasTagName(parameters.state.getType()))
+    {
+        parameters.replaceState(juce::ValueTree::fromXml(*xml));
+
+        // Not left to the timer when we can help it: the host may start
+        // rendering straight away
+        if (juce::MessageManager::existsAndIsCurrentThread())
+            publishSettings();
+    }
+}
+
+//==============================================================================
+void TrackTweakAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    settingsDirty.store(true, std::memory_order_relaxed);
+}
+
+void TrackTweakAudioProcessor::timerCallback()
+{
+    if (settingsDirty.exchange(false, std::memory_order_relaxed))
+        publishSettings();
+}
+
+void TrackTweakAudioProcessor::publishSettings()
+{
+    settingsDirty.store(false, std::memory_order_relaxed);
+    settingsPublisher.publish(AnalyzerSettings::fromParameters(parameters));
+    spectrumEngine.settingsChanged();
 }
 
 //==============================================================================
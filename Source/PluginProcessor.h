@@ -7,9 +7,25 @@
 #pragma once
 #include <JuceHeader.h>
 #include <atomic>
+#include "AnalyzerSettings.h"
+#include "DynamicsMeter.h"
+#include "EditorAssets.h"
+#include "InstanceRegistry.h"
+#include "LoudnessMeter.h"
+#include "LoudnessTimeline.h"
+#include "MeterEvents.h"
+#include "MeterFeed.h"
+#include "OctaveBandMeter.h"
+#include "ProcessingCost.h"
+#include "SnapshotStore.h"
+#include "SpectrumEngine.h"
+#include "TraceRecorder.h"
 
 //==============================================================================
-class TrackTweakAudioProcessor : public juce::AudioProcessor
+class TrackTweakAudioProcessor : public juce::AudioProcessor,
+                                  private SpectrumEngine::FrameListener,
+                                  private juce::AudioProcessorValueTreeState::Listener,
+                                  private juce::Timer
 {
 public:
     //==============================================================================
@@ -25,6 +41,8 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -48,62 +66,139 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // Analyzer settings as host parameters. The editor attaches to these;
+    // everything else reads the published snapshot.
+    juce::AudioProcessorValueTreeState& getParameters() { return parameters; }
+
+    // Message thread: the settings as last published
+    const AnalyzerSettings& getAnalyzerSettings() const { return settingsPublisher.getLatest(); }
+
+    // The host's track name labels this instance on the meter feed
+    void updateTrackProperties(const TrackProperties& properties) override;
+
     //==============================================================================
     // Loudness measurement access for GUI
     float getRMSLevel() const;
+    float getPeakLevel() const;
     float getMomentaryLUFS() const;
     float getShortTermLUFS() const;
     float getIntegratedLUFS() const;
+    float getLoudnessRange() const { return loudnessMeter.getLoudnessRange(); }
+    float getTruePeakDecibels() const { return loudnessMeter.getTruePeakDecibels(); }
 
-    // Spectrum analyzer access for GUI
-    void getSpectrumData(std::vector<float>& spectrumData);
-    static constexpr int spectrumSize = 512; // Number of frequency bins for display
+    // Dynamics, in dB: crest factor and DR score over the programme,
+    // peak-to-loudness (true peak - integrated) and peak-to-short-term
+    // (3 s true peak - short-term loudness)
+    float getCrestFactor() const { return dynamicsMeter.getCrestFactor(); }
+    float getDynamicRange() const { return dynamicsMeter.getDynamicRange(); }
+    float getPeakToLoudnessRatio() const;
+    float getPeakToShortTermRatio() const;
 
-private:
-    //==============================================================================
-    // RMS calculation variables
-    std::atomic<float> currentRMSLevel{ 0.0f };
+    // Loudness of everything heard so far, by timeline position
+    LoudnessTimeline& getLoudnessTimeline() { return loudnessTimeline; }
 
-    // LUFS calculation variables
-    std::atomic<float> currentMomentaryLUFS{ -70.0f };
-    std::atomic<float> currentShortTermLUFS{ -70.0f };
-    std::atomic<float> currentIntegratedLUFS{ -70.0f };
+    // Clips, overs, silences, DC offset and loudness excursions; the editor
+    // drains the events
+    MeterEventDetector& getEventDetector() { return eventDetector; }
 
-    // Simple circular buffers for LUFS timing
-    juce::AudioBuffer<float> momentaryBuffer;
-    juce::AudioBuffer<float> shortTermBuffer;
-    int momentaryWritePos = 0;
-    int shortTermWritePos = 0;
-    double sampleRate = 44100.0;
+    // Sidechain reference (silence when the bus is disabled)
+    float getReferenceIntegratedLUFS() const { return referenceLoudnessMeter.getIntegratedLUFS(); }
 
-    // Spectrum analyzer variables
-    static constexpr int fftOrder = 11;         // 2^11 = 2048 samples
-    static constexpr int fftSize = 1 << fftOrder; // 2048
+    // Spectrum analyzer access for GUI
+    void getSpectrumData(std::vector<float>& spectrumData, int trace = 0);
+    static constexpr int spectrumSize = 512; // Number of frequency bins for display
+    SpectrumEngine& getSpectrumEngine() { return spectrumEngine; }
 
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
+    // Octave / third-octave band meter access for GUI
+    const OctaveBandMeter& getOctaveBandMeter() const { return bandMeter; }
 
-    std::array<float, fftSize> fftData;
-    std::array<float, fftSize * 2> fftBuffer; // Complex FFT needs 2x size
-    std::vector<float> spectrumMagnitudes;
+    // What each audio callback costs, averaged and worst over the last second
+    const ProcessingCost& getProcessingCost() const { return processingCost; }
 
-    juce::AbstractFifo abstractFifo;
-    std::array<float, fftSize> fifoBuffer;
+    // A/B snapshots, shared by every instance. Capturing stores the current
+    // traces, long-term average and loudness under the given name (message
+    // thread); false if the store couldn't be written.
+    SnapshotStore& getSnapshotStore() { return *snapshotStore; }
+    bool captureSnapshot(const juce::String& name);
 
-    int fifoIndex = 0;
-    bool nextFFTBlockReady = false;
+    // Fonts, images and glyphs shared by every editor in the process
+    EditorAssets& getEditorAssets() { return *editorAssets; }
 
-    juce::CriticalSection spectrumDataMutex;
-    std::vector<float> smoothedSpectrum;
+    // This instance's entry in the process-wide registry (null if it was full)
+    const InstanceRegistry::Entry* getRegistryEntry() const { return registryEntry; }
 
-    // Helper methods for LUFS calculation
-    void updateLUFSMeasurements(const juce::AudioBuffer<float>& buffer);
-    float calculateSimpleLUFS(const juce::AudioBuffer<float>& buffer, int numSamplesToUse) const;
+private:
+    //==============================================================================
+    // RMS calculation variables
+    std::atomic<float> currentRMSLevel{ 0.0f };
+    std::atomic<float> currentPeakLevel{ 0.0f };
+
+    // LUFS measurement (100 ms gating-block history, survives block size changes)
+    LoudnessMeter loudnessMeter;
+    LoudnessMeter referenceLoudnessMeter;
+    LoudnessTimeline loudnessTimeline{ loudnessMeter };
+    DynamicsMeter dynamicsMeter;
+    double sampleRate = 44100.0;
 
-    // Helper methods for spectrum analysis
-    void pushSamplesToFifo(const juce::AudioBuffer<float>& buffer);
-    void performFFT();
-    void updateSpectrum();
+    // Shared-memory feed for external dashboards and the in-process overview,
+    // both written from the analysis worker. Declared before the engine so
+    // they outlive the worker thread.
+    MeterFeed meterFeed;
+    InstanceRegistry::Entry* registryEntry = nullptr;
+    MeterEventDetector eventDetector;
+    std::atomic<juce::int64> latestTimelinePosition{ -1 };   // for events found by the worker
+    void spectrumFrameAnalysed(const float* decibels, int numColumns, const AnalyzerSettings& settings) override;
+
+    // Parameter changes (from any thread, automation included) only raise a
+    // flag; the timer turns them into one new snapshot on the message thread
+    juce::AudioProcessorValueTreeState parameters{ *this, nullptr, "TrackTweak", AnalyzerSettings::createParameterLayout() };
+    AnalyzerSettingsPublisher settingsPublisher;
+    std::atomic<bool> settingsDirty{ false };
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void timerCallback() override;
+    void publishSettings();
+
+    // Spectrum analysis runs on its own worker and the audio thread only
+    // feeds it, unless built for inline analysis (see SpectrumEngine)
+    SpectrumEngine spectrumEngine{ spectrumSize, settingsPublisher, TRACKTWEAK_INLINE_ANALYSIS != 0 };
+
+    // Time-domain band levels (complements the FFT at low frequencies)
+    OctaveBandMeter bandMeter;
+
+    juce::SharedResourcePointer<SnapshotStore> snapshotStore;
+    juce::SharedResourcePointer<EditorAssets> editorAssets;
+
+    // Shared float/double metering path - the host's buffer is read in its
+    // native precision, with no conversion copy
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    // All analysis runs on fixed 64-sample sub-blocks, whatever the host's
+    // block size: each stage in turn over data that is still in L1. A tail
+    // shorter than a sub-block is carried (in double) to the next callback.
+    static constexpr int subBlockSize = 64;
+    static constexpr int maxAnalysisChannels = 2;
+
+    template <typename SampleType>
+    void analyseSubBlock(const SampleType* const* input, int numInputChannels,
+                         const SampleType* const* reference, int numReferenceChannels,
+                         int numSamples, juce::int64 timelinePosition, bool offline);
+
+    // Track channels, then reference channels
+    std::array<std::array<double, subBlockSize>, maxAnalysisChannels * 2> carriedSamples{};
+    int numCarriedSamples = 0;
+    int carriedInputChannels = 0, carriedReferenceChannels = 0;
+
+    ProcessingCost processingCost;
+
+    // Time spent in the loudness and band stages over one callback's
+    // sub-blocks, for the trace (see TRACKTWEAK_TRACE_ACCUMULATE)
+    juce::int64 tracedLoudnessTicks = 0, tracedBandMeterTicks = 0;
+
+    // RMS / peak accumulated over the sub-blocks of one callback
+    double levelSumSquares = 0.0;
+    float levelPeak = 0.0f;
+    int levelSampleCount = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackTweakAudioProcessor)
 };
\ No newline at end of file
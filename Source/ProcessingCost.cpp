@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+    Wall-clock cost of the audio callback: average, peak and their ratio.
+  ==============================================================================
+*/
+
+#include "ProcessingCost.h"
+
+//==============================================================================
+float ProcessingCost::getPeakToAverage() const
+{
+    const float average = getAverageMicroseconds();
+    return average > 0.0f ? getPeakMicroseconds() / average : 0.0f;
+}
+
+void ProcessingCost::addCallback(juce::int64 ticks, int numSamples) noexcept
+{
+    totalTicks += ticks;
+    peakTicks = juce::jmax(peakTicks, ticks);
+    ++numCallbacks;
+    numSamplesMeasured += numSamples;
+
+    if (numSamplesMeasured < samplesPerReport.load(std::memory_order_relaxed))
+        return;
+
+    const double microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    averageMicroseconds.store(static_cast<float>(static_cast<double>(totalTicks) * microsecondsPerTick / numCallbacks),
+                              std::memory_order_relaxed);
+    peakMicroseconds.store(static_cast<float>(static_cast<double>(peakTicks) * microsecondsPerTick),
+                           std::memory_order_relaxed);
+
+    totalTicks = peakTicks = 0;
+    numCallbacks = numSamplesMeasured = 0;
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+    Wall-clock cost of the audio callback: average, peak and their ratio.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+// Times every callback with two tick reads and reports once per second of
+// audio: the mean, the worst, and worst over mean. The worst callback is what
+// has to fit in a small host buffer, so a ratio close to 1 means work that
+// arrives in bursts (a gating block, a spectrum frame) is being spread out.
+class ProcessingCost
+{
+public:
+    // Message thread
+    void prepare(double sampleRate) { samplesPerReport.store(juce::jmax(1, juce::roundToInt(sampleRate))); }
+
+    // Audio thread: times the enclosing scope
+    class Scope
+    {
+    public:
+        Scope(ProcessingCost& costToUpdate, int numSamplesInCallback) noexcept
+            : cost(costToUpdate), numSamples(numSamplesInCallback), start(juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~Scope() { cost.addCallback(juce::Time::getHighResolutionTicks() - start, numSamples); }
+
+    private:
+        ProcessingCost& cost;
+        const int numSamples;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    // Any thread; 0 until the first second has been reported
+    float getAverageMicroseconds() const { return averageMicroseconds.load(std::memory_order_relaxed); }
+    float getPeakMicroseconds() const { return peakMicroseconds.load(std::memory_order_relaxed); }
+    float getPeakToAverage() const;
+
+private:
+    void addCallback(juce::int64 ticks, int numSamples) noexcept;
+
+    std::atomic<int> samplesPerReport{ 44100 };
+
+    // Audio-thread state for the second being measured
+    juce::int64 totalTicks = 0, peakTicks = 0;
+    int numCallbacks = 0, numSamplesMeasured = 0;
+
+    std::atomic<float> averageMicroseconds{ 0.0f }, peakMicroseconds{ 0.0f };
+};
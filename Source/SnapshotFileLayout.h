@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+    Snapshot store: file layout shared by the plugin and external readers.
+    Plain C++ with no JUCE dependency so external tools can include it.
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// A header followed by fixed-size records, in native byte order. Nothing is
+// parsed on load: the file is mapped read-only and records are used in place,
+// so opening a store of hundreds of snapshots costs one mmap.
+namespace SnapshotFileLayout
+{
+    constexpr std::uint32_t magic = 0x54545353; // 'TTSS'
+    constexpr std::uint32_t version = 1;
+    constexpr int numColumns = 512;             // display columns, log-spaced 20 Hz - 20 kHz
+    constexpr int numTraces = 2;
+    constexpr int maxNameLength = 64;
+
+    enum Flags : std::uint32_t
+    {
+        stereo      = 1u << 0,
+        midSide     = 1u << 1,      // traces are mid / side rather than left / right
+        hasLongTerm = 1u << 2
+    };
+
+    // One captured snapshot. Levels are dB (LUFS, LU, dBTP, dBFS); spectra
+    // are in dB per display column, already smoothed and calibrated, so they
+    // overlay the live traces column for column.
+    struct Record
+    {
+        char name[maxNameLength];           // UTF-8, null-terminated
+        char source[maxNameLength];         // track it was captured on
+        std::int64_t createdMilliseconds;   // since 1970; also identifies the record
+        std::uint32_t flags;
+        std::uint32_t fftSize;
+        float sampleRate;
+
+        float integratedLUFS;
+        float loudnessRange;
+        float truePeakDecibels;
+        float maxSamplePeakDecibels;
+        float crestFactor;
+        float dynamicRange;
+        float peakToLoudnessRatio;
+
+        float spectrum[numTraces][numColumns];
+        float longTerm[numColumns];
+    };
+
+    // numRecords is rewritten only after the record it counts is complete,
+    // so an interrupted append leaves the previous count in place
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t numColumns;
+        std::uint32_t recordSize;
+        std::uint32_t numRecords;
+        std::uint32_t reserved[11];
+    };
+
+    static_assert(sizeof(Header) == 64, "Header layout must not change");
+    static_assert(sizeof(Record) % 8 == 0, "Records must stay 8-byte aligned when packed");
+    static_assert(std::is_trivially_copyable<Record>::value && std::is_trivially_copyable<Header>::value,
+                  "Layout types are copied and mapped as raw bytes");
+
+    inline bool isValid(const Header& header) noexcept
+    {
+        return header.magic == magic && header.version == version
+            && header.numColumns == static_cast<std::uint32_t>(numColumns)
+            && header.recordSize == sizeof(Record);
+    }
+}
@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+    Named spectrum and loudness snapshots for A/B comparison, kept in one
+    memory-mapped file shared by every instance, session and track.
+  ==============================================================================
+*/
+
+#include "SnapshotStore.h"
+#include <cstring>
+
+namespace
+{
+    juce::File getStoreFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("TrackTweak")
+            .getChildFile("Snapshots.ttsnap");
+    }
+
+    SnapshotFileLayout::Header createHeader(std::uint32_t numRecords)
+    {
+        SnapshotFileLayout::Header header{};
+        header.magic = SnapshotFileLayout::magic;
+        header.version = SnapshotFileLayout::version;
+        header.numColumns = SnapshotFileLayout::numColumns;
+        header.recordSize = sizeof(SnapshotFileLayout::Record);
+        header.numRecords = numRecords;
+        return header;
+    }
+
+    void copyName(char* destination, const juce::String& name)
+    {
+        name.copyToUTF8(destination, SnapshotFileLayout::maxNameLength);
+    }
+}
+
+//==============================================================================
+SnapshotStore::SnapshotStore()
+    : file(getStoreFile())
+{
+    map();
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    unmap();
+}
+
+const SnapshotStore::Record* SnapshotStore::getSnapshot(int index) const
+{
+    return juce::isPositiveAndBelow(index, numRecords) ? records + index : nullptr;
+}
+
+int SnapshotStore::indexOf(juce::int64 createdMilliseconds) const
+{
+    for (int i = 0; i < numRecords; ++i)
+        if (records[i].createdMilliseconds == createdMilliseconds)
+            return i;
+
+    return -1;
+}
+
+juce::String SnapshotStore::getName(const Record& record)
+{
+    return juce::String::fromUTF8(record.name, static_cast<int>(::strnlen(record.name, sizeof(record.name))));
+}
+
+void SnapshotStore::setName(Record& record, const juce::String& name)
+{
+    copyName(record.name, name);
+}
+
+void SnapshotStore::setSource(Record& record, const juce::String& source)
+{
+    copyName(record.source, source);
+}
+
+//==============================================================================
+void SnapshotStore::map()
+{
+    unmap();
+
+    mappedSize = file.getSize();
+    mappedModificationTime = file.getLastModificationTime();
+
+    if (mappedSize < static_cast<juce::int64>(sizeof(SnapshotFileLayout::Header)))
+        return;
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto* bytes = static_cast<const char*>(mapping->getData());
+
+    if (bytes == nullptr || mapping->getSize() < sizeof(SnapshotFileLayout::Header))
+        return;
+
+    const auto& header = *reinterpret_cast<const SnapshotFileLayout::Header*>(bytes);
+
+    if (! SnapshotFileLayout::isValid(header))
+        return;
+
+    // Only whole records count, whatever the header claims
+    const auto available = (mapping->getSize() - sizeof(SnapshotFileLayout::Header)) / sizeof(Record);
+    numRecords = static_cast<int>(juce::jmin(static_cast<size_t>(header.numRecords), available));
+    records = reinterpret_cast<const Record*>(bytes + sizeof(SnapshotFileLayout::Header));
+    mappedFile = std::move(mapping);
+}
+
+void SnapshotStore::unmap()
+{
+    records = nullptr;
+    numRecords = 0;
+    mappedFile.reset();
+}
+
+void SnapshotStore::refresh()
+{
+    if (file.getSize() == mappedSize && file.getLastModificationTime() == mappedModificationTime)
+        return;
+
+    map();
+    sendChangeMessage();
+}
+
+bool SnapshotStore::readHeader(SnapshotFileLayout::Header& header) const
+{
+    juce::FileInputStream input(file);
+    return input.openedOk()
+        && input.read(&header, sizeof(header)) == static_cast<int>(sizeof(header))
+        && SnapshotFileLayout::isValid(header);
+}
+
+//==============================================================================
+bool SnapshotStore::add(const Record& record)
+{
+    const juce::InterProcessLock::ScopedLockType lock(fileLock);
+
+    // Some platforms can't write to a file that is mapped
+    unmap();
+
+    // A file from another version is kept aside rather than overwritten
+    SnapshotFileLayout::Header header{};
+
+    if (file.existsAsFile() && ! readHeader(header))
+        file.moveFileTo(file.getNonexistentSibling());
+
+    if (! file.existsAsFile())
+    {
+        file.getParentDirectory().createDirectory();
+        header = createHeader(0);
+    }
+
+    bool written = false;
+
+    {
+        juce::FileOutputStream output(file);
+
+        // The record goes in first; only then is it counted
+        if (output.openedOk()
+            && output.setPosition(static_cast<juce::int64>(sizeof(header))
+                                  + static_cast<juce::int64>(header.numRecords) * static_cast<juce::int64>(sizeof(Record)))
+            && output.write(&record, sizeof(record)))
+        {
+            output.flush();
+            ++header.numRecords;
+            written = output.setPosition(0) && output.write(&header, sizeof(header));
+            output.flush();
+        }
+    }
+
+    map();
+    sendChangeMessage();
+    return written;
+}
+
+bool SnapshotStore::remove(juce::int64 createdMilliseconds)
+{
+    const juce::InterProcessLock::ScopedLockType lock(fileLock);
+
+    // Work from the file as it is now, in case another process added to it
+    map();
+    const int index = indexOf(createdMilliseconds);
+
+    if (index < 0)
+    {
+        sendChangeMessage();
+        return false;
+    }
+
+    // Survivors are written to a temporary file that then replaces the store
+    const auto header = createHeader(static_cast<std::uint32_t>(numRecords - 1));
+    const auto recordsAfter = static_cast<size_t>(numRecords - index - 1);
+    juce::TemporaryFile temporary(file);
+    bool written = false;
+
+    {
+        juce::FileOutputStream output(temporary.getFile());
+
+        written = output.openedOk()
+               && output.write(&header, sizeof(header))
+               && (index == 0 || output.write(records, static_cast<size_t>(index) * sizeof(Record)))
+               && (recordsAfter == 0 || output.write(records + index + 1, recordsAfter * sizeof(Record)));
+        output.flush();
+    }
+
+    unmap();
+    written = written && temporary.overwriteTargetFileWithTemporary();
+
+    map();
+    sendChangeMessage();
+    return written;
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+    Named spectrum and loudness snapshots for A/B comparison, kept in one
+    memory-mapped file shared by every instance, session and track.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SnapshotFileLayout.h"
+
+//==============================================================================
+// The file is mapped read-only and records are read in place, so loading a
+// store of any size is one mmap and no parsing. Changes are rare and go
+// through the file: a capture appends one record and then bumps the count,
+// a removal rewrites the file and swaps it in. Either way the file is
+// mapped again and listeners are told. Writers in other processes are kept
+// out by an inter-process lock; their changes are picked up by refresh().
+//
+// One store is shared by all instances in the process (hold it through a
+// juce::SharedResourcePointer). Message thread only.
+class SnapshotStore : public juce::ChangeBroadcaster
+{
+public:
+    using Record = SnapshotFileLayout::Record;
+
+    SnapshotStore();
+    ~SnapshotStore() override;
+
+    int getNumSnapshots() const { return numRecords; }
+
+    // Points into the mapping: valid until the store next changes
+    const Record* getSnapshot(int index) const;
+
+    // Index of the snapshot captured at that time, or -1
+    int indexOf(juce::int64 createdMilliseconds) const;
+
+    // False if the file couldn't be written
+    bool add(const Record& record);
+    bool remove(juce::int64 createdMilliseconds);
+
+    // Maps the file again if another process changed it
+    void refresh();
+
+    const juce::File& getFile() const { return file; }
+
+    static juce::String getName(const Record& record);
+    static void setName(Record& record, const juce::String& name);
+    static void setSource(Record& record, const juce::String& source);
+
+private:
+    void map();
+    void unmap();
+    bool readHeader(SnapshotFileLayout::Header& header) const;
+
+    const juce::File file;
+    juce::InterProcessLock fileLock{ "TrackTweakSnapshots" };
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const Record* records = nullptr;
+    int numRecords = 0;
+
+    // What was mapped, to notice changes made elsewhere
+    juce::int64 mappedSize = -1;
+    juce::Time mappedModificationTime;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SnapshotStore)
+};
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+    Power-domain spectral averaging with peak-hold and max-hold traces.
+  ==============================================================================
+*/
+
+#include "SpectrumAverager.h"
+
+namespace
+{
+    using FVO = juce::FloatVectorOperations;
+}
+
+//==============================================================================
+void SpectrumAverager::prepare(int newNumBins)
+{
+    setNumBins(newNumBins);
+    clearBins(0, numBins);
+}
+
+void SpectrumAverager::reserve(int maxBins)
+{
+    // Sized now, so later plans only change numBins
+    const auto bins = static_cast<size_t>(maxBins);
+
+    for (auto* buffer : { &average, &peakHold, &maxHold, &rmsSum })
+        buffer->resize(juce::jmax(buffer->size(), bins));
+
+    rmsHistory.resize(juce::jmax(rmsHistory.size(), bins * maxRMSFrames));
+}
+
+void SpectrumAverager::setNumBins(int newNumBins)
+{
+    numBins = newNumBins;
+    const auto bins = static_cast<size_t>(numBins);
+
+    // Only grows. The RMS history needs no clearing: a slot is always
+    // written before it is read.
+    for (auto* buffer : { &average, &peakHold, &maxHold, &rmsSum })
+        if (buffer->size() < bins)
+            buffer->resize(bins);
+
+    if (rmsHistory.size() < bins * maxRMSFrames)
+        rmsHistory.resize(bins * maxRMSFrames);
+
+    rmsWritePos = 0;
+    rmsFilled = 0;
+    framesSinceResum = 0;
+    infiniteCount = 0;
+}
+
+void SpectrumAverager::clearBins(int firstBin, int endBin)
+{
+    const int count = endBin - firstBin;
+
+    FVO::clear(average.data() + firstBin, count);
+    FVO::clear(peakHold.data() + firstBin, count);
+    FVO::clear(maxHold.data() + firstBin, count);
+    FVO::clear(rmsSum.data() + firstBin, count);
+}
+
+void SpectrumAverager::reset()
+{
+    FVO::clear(average.data(), numBins);
+    FVO::clear(peakHold.data(), numBins);
+    FVO::clear(rmsSum.data(), numBins);
+
+    rmsWritePos = 0;
+    rmsFilled = 0;
+    framesSinceResum = 0;
+    infiniteCount = 0;
+
+    resetMaxHold();
+}
+
+void SpectrumAverager::resetMaxHold()
+{
+    FVO::clear(maxHold.data(), numBins);
+}
+
+//==============================================================================
+void SpectrumAverager::addFrame(const float* power, Mode mode, float exponentialWeight, int rmsFrames,
+                                float peakDecaydBPerSecond, float frameIntervalSeconds)
+{
+    rmsFrames = juce::jlimit(1, maxRMSFrames, rmsFrames);
+
+    // Switching mode or RMS length starts the average afresh
+    if (mode != lastMode || (mode == Mode::rms && rmsFrames != rmsLength))
+    {
+        FVO::copy(average.data(), power, numBins);
+        FVO::clear(rmsSum.data(), numBins);
+        rmsWritePos = 0;
+        rmsFilled = 0;
+        infiniteCount = 0;
+        lastMode = mode;
+        rmsLength = rmsFrames;
+    }
+
+    switch (mode)
+    {
+        case Mode::exponential:
+        {
+            // avg += w * (p - avg)
+            FVO::multiply(average.data(), 1.0f - exponentialWeight, numBins);
+            FVO::addWithMultiply(average.data(), power, exponentialWeight, numBins);
+            break;
+        }
+
+        case Mode::infinite:
+        {
+            // Running mean: weight of the n-th frame is 1 / n
+            const float weight = 1.0f / static_cast<float>(++infiniteCount);
+            FVO::multiply(average.data(), 1.0f - weight, numBins);
+            FVO::addWithMultiply(average.data(), power, weight, numBins);
+            break;
+        }
+
+        case Mode::rms:
+        {
+            auto* slot = rmsHistory.data() + static_cast<size_t>(rmsWritePos) * static_cast<size_t>(numBins);
+
+            if (rmsFilled == rmsLength)
+                FVO::subtract(rmsSum.data(), slot, numBins);
+            else
+                ++rmsFilled;
+
+            FVO::copy(slot, power, numBins);
+            FVO::add(rmsSum.data(), power, numBins);
+            rmsWritePos = (rmsWritePos + 1) % rmsLength;
+
+            // Rebuild the running sum now and then so float drift can't accumulate
+            if (++framesSinceResum >= maxRMSFrames)
+            {
+                framesSinceResum = 0;
+                FVO::clear(rmsSum.data(), numBins);
+
+                for (int frame = 0; frame < rmsFilled; ++frame)
+                    FVO::add(rmsSum.data(), rmsHistory.data() + static_cast<size_t>(frame) * static_cast<size_t>(numBins), numBins);
+            }
+
+            FVO::copyWithMultiply(average.data(), rmsSum.data(), 1.0f / static_cast<float>(rmsFilled), numBins);
+            break;
+        }
+    }
+
+    // Peak hold decays geometrically in power, then takes the new frame's peaks
+    const float decayGain = std::pow(10.0f, -peakDecaydBPerSecond * frameIntervalSeconds / 10.0f);
+    FVO::multiply(peakHold.data(), decayGain, numBins);
+    FVO::max(peakHold.data(), peakHold.data(), power, numBins);
+
+    FVO::max(maxHold.data(), maxHold.data(), power, numBins);
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+    Power-domain spectral averaging with peak-hold and max-hold traces.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Averages linear power per FFT bin. Every update is a handful of whole-array
+// FloatVectorOperations passes; nothing here takes a log - conversion to dB
+// happens later, once per display column.
+class SpectrumAverager
+{
+public:
+    enum class Mode { exponential = 0, rms, infinite };
+
+    static constexpr int maxRMSFrames = 64;
+
+    // Worker thread, when the FFT plan changes (allocates, unless reserve()
+    // was called for at least this many bins)
+    void prepare(int numBins);
+    void reserve(int maxBins);
+    void reset();
+    void resetMaxHold();
+
+    // prepare() in two halves, so the clearing can be spread out: the new
+    // bin count and a fresh start, then the bins a stretch at a time. No
+    // frame may be added until every bin has been cleared.
+    void setNumBins(int numBins);
+    void clearBins(int firstBin, int endBin);
+
+    // exponentialWeight: share of each new frame (0..1)
+    // rmsFrames: length of the moving average (1..maxRMSFrames)
+    // peakDecaydBPerSecond: fall rate of the peak-hold trace
+    void addFrame(const float* power, Mode mode, float exponentialWeight, int rmsFrames,
+                  float peakDecaydBPerSecond, float frameIntervalSeconds);
+
+    const float* getAverage() const { return average.data(); }
+    const float* getPeakHold() const { return peakHold.data(); }
+    const float* getMaxHold() const { return maxHold.data(); }
+
+private:
+    int numBins = 0;
+
+    std::vector<float> average, peakHold, maxHold;
+
+    // N-frame moving average: ring of past frames plus their running sum
+    std::vector<float> rmsHistory, rmsSum;
+    int rmsWritePos = 0;
+    int rmsFilled = 0;
+    int rmsLength = 0;
+    int framesSinceResum = 0;
+
+    juce::int64 infiniteCount = 0;
+    Mode lastMode = Mode::exponential;
+};
@@ -0,0 +1,1010 @@
+/*
+  ==============================================================================
+    Background spectrum analysis: FFT plans, window tables and display mapping.
+  ==============================================================================
+*/
+
+#include "SpectrumEngine.h"
+#include "DecibelConversion.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+    constexpr float kaiserBeta = 8.6f;   // ~ -70 dB side lobes
+
+    juce::dsp::WindowingFunction<float>::WindowingMethod toJuceWindow(SpectrumPlan::WindowType type)
+    {
+        using Method = juce::dsp::WindowingFunction<float>;
+
+        switch (type)
+        {
+            case SpectrumPlan::WindowType::blackmanHarris: return Method::blackmanHarris;
+            case SpectrumPlan::WindowType::flatTop:        return Method::flatTop;
+            case SpectrumPlan::WindowType::kaiser:         return Method::kaiser;
+            case SpectrumPlan::WindowType::hann:
+            default:                                       return Method::hann;
+        }
+    }
+}
+
+//==============================================================================
+SpectrumPlan::SpectrumPlan(int fftOrder, WindowType type, double sr, int numDisplayPoints)
+    : order(fftOrder),
+      size(1 << fftOrder),
+      windowType(type),
+      sampleRate(sr)
+{
+    window.resize(static_cast<size_t>(size));
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(size),
+        toJuceWindow(type), false, kaiserBeta);
+
+    // Coherent gain and equivalent noise bandwidth of this window
+    double sum = 0.0, sumSquares = 0.0;
+    for (auto w : window)
+    {
+        sum += w;
+        sumSquares += static_cast<double>(w) * w;
+    }
+
+    amplitudeScale = static_cast<float>(2.0 / sum);
+    enbwBins = static_cast<float>(size * sumSquares / (sum * sum));
+
+    frameBuffers.push_back(std::make_unique<FrameBuffers>(order, size));
+    trackMeanPower.resize(static_cast<size_t>(size / 2 + 1), 0.0f);
+
+    // Column edges sit half a column either side of each column's frequency
+    const int numBins = size / 2;
+    const float binWidth = static_cast<float>(sampleRate) / static_cast<float>(size);
+    const float logSpan = std::log(maxDisplayFrequency / minDisplayFrequency);
+
+    auto columnToBin = [&](float column)
+    {
+        const float position = column / static_cast<float>(numDisplayPoints - 1);
+        return minDisplayFrequency * std::exp(position * logSpan) / binWidth;
+    };
+
+    binStart.resize(static_cast<size_t>(numDisplayPoints));
+    binEnd.resize(static_cast<size_t>(numDisplayPoints));
+    binFraction.resize(static_cast<size_t>(numDisplayPoints));
+
+    for (int i = 0; i < numDisplayPoints; ++i)
+    {
+        const float centreBin = columnToBin(static_cast<float>(i));
+        const int first = static_cast<int>(std::ceil(columnToBin(static_cast<float>(i) - 0.5f)));
+        const int last = static_cast<int>(std::floor(columnToBin(static_cast<float>(i) + 0.5f)));
+
+        if (last >= first)
+        {
+            binStart[static_cast<size_t>(i)] = juce::jlimit(1, numBins - 1, first);
+            binEnd[static_cast<size_t>(i)] = juce::jlimit(binStart[static_cast<size_t>(i)] + 1, numBins, last + 1);
+            binFraction[static_cast<size_t>(i)] = 0.0f;
+        }
+        else
+        {
+            const int lower = juce::jlimit(1, numBins - 2, static_cast<int>(centreBin));
+            binStart[static_cast<size_t>(i)] = lower;
+            binEnd[static_cast<size_t>(i)] = lower; // empty range = interpolate
+            binFraction[static_cast<size_t>(i)] = juce::jlimit(0.0f, 1.0f, centreBin - static_cast<float>(lower));
+        }
+    }
+}
+
+SpectrumPlan::FrameBuffers::FrameBuffers(int fftOrder, int size)
+    : fft(fftOrder)
+{
+    timeData.resize(static_cast<size_t>(size));
+    referenceSpectrum.resize(static_cast<size_t>(size));
+
+    for (auto& channelSamples : samples)
+        channelSamples.resize(static_cast<size_t>(size), 0.0f);
+}
+
+//==============================================================================
+SpectrumEngine::SpectrumEngine(int numDisplayPoints, AnalyzerSettingsPublisher& publisher, bool analyseOnAudioThread)
+    : juce::Thread("TrackTweak Analysis"),
+      numDisplayColumns(numDisplayPoints),
+      settingsPublisher(publisher),
+      inlineMode(analyseOnAudioThread)
+{
+    const float floordB = settings->displayFloor;
+
+    for (auto& fifo : fifoBuffers)
+        fifo.resize(static_cast<size_t>(fifoSize), 0.0f);
+
+    for (auto& channelHistory : history)
+        channelHistory.resize(static_cast<size_t>(1 << maxFFTOrder), 0.0f);
+
+    for (auto& trace : spectrumMagnitudes)
+        for (auto& display : trace)
+            display.resize(static_cast<size_t>(numDisplayColumns), floordB);
+
+    for (auto& scratch : columnScratch)
+        scratch.resize(static_cast<size_t>(numDisplayColumns), 0.0f);
+
+    referenceMagnitudes.resize(static_cast<size_t>(numDisplayColumns), floordB);
+
+    for (auto* columns : { &longTermMagnitudes, &targetCentre, &targetTolerance, &targetLow, &targetHigh })
+        columns->resize(static_cast<size_t>(numDisplayColumns), 0.0f);
+
+    longTermSum.resize(static_cast<size_t>((1 << maxFFTOrder) / 2 + 1), 0.0);
+    longTermPower.resize(longTermSum.size(), 0.0f);
+    differenceMagnitudes.resize(static_cast<size_t>(numDisplayColumns), 0.0f);
+
+    frameBus.addConsumer(this);
+
+    if (! inlineMode)
+    {
+        settingsChanged();
+        startThread(juce::Thread::Priority::low);
+        return;
+    }
+
+    // The audio thread only ever resizes these within what is reserved here
+    const int maxBins = (1 << maxFFTOrder) / 2 + 1;
+
+    for (auto& averager : averagers)
+        averager.reserve(maxBins);
+
+    for (auto& scratch : smoothedPower)
+        scratch.resize(static_cast<size_t>(maxBins));
+
+    // The frame in flight and a few held by views
+    frameBus.reserve(1 << maxFFTOrder, 4);
+
+    inlinePlanOrder = settings->fftOrder;
+    inlinePlanWindow = settings->windowType;
+    plan = std::make_unique<SpectrumPlan>(inlinePlanOrder, inlinePlanWindow, requestedSampleRate.load(), numDisplayColumns);
+    planChanged();
+
+    inlineSmootherFraction = settings->smoothingFraction;
+    smoother->prepare(plan->size / 2 + 1, inlineSmootherFraction);
+    settingsChanged();
+}
+
+SpectrumEngine::~SpectrumEngine()
+{
+    stopThread(2000);
+    frameBus.removeConsumer(this);
+    delete pendingPlan.exchange(nullptr);
+    delete retiredPlan.exchange(nullptr);
+    delete pendingSmoother.exchange(nullptr);
+    delete retiredSmoother.exchange(nullptr);
+}
+
+void SpectrumEngine::prepare(double sampleRate)
+{
+    requestedSampleRate.store(sampleRate);
+
+    if (inlineMode)
+        buildInlinePlan();
+    else
+        notify();
+}
+
+void SpectrumEngine::settingsChanged()
+{
+    const auto& latest = settingsPublisher.getLatest();
+
+    if (latest.targetCurve != mappedTarget)
+    {
+        const juce::ScopedLock lock(spectrumDataMutex);
+        SpectrumTargets::fillColumns(latest.targetCurve, targetCentre.data(), targetTolerance.data(), numDisplayColumns);
+        mappedTarget = latest.targetCurve;
+    }
+
+    if (! inlineMode)
+        notify();
+    else if (latest.fftOrder != inlinePlanOrder || latest.windowType != inlinePlanWindow)
+        buildInlinePlan();
+    else if (latest.smoothingFraction != inlineSmootherFraction)
+        buildInlineSmoother();
+}
+
+void SpectrumEngine::setFrameListener(FrameListener* newListener)
+{
+    const juce::SpinLock::ScopedLockType lock(listenerLock);
+    frameListener = newListener;
+}
+
+void SpectrumEngine::setBulkMode(bool shouldUseBulkMode)
+{
+    bulkMode.store(shouldUseBulkMode && ! inlineMode, std::memory_order_relaxed);
+}
+
+float SpectrumEngine::frequencyToDisplayPosition(float frequency)
+{
+    return std::log(frequency / SpectrumPlan::minDisplayFrequency)
+         / std::log(SpectrumPlan::maxDisplayFrequency / SpectrumPlan::minDisplayFrequency);
+}
+
+//==============================================================================
+void SpectrumEngine::run()
+{
+    while (! threadShouldExit())
+    {
+        settings.update();
+        updatePlanIfNeeded();
+        updateSmootherIfNeeded();
+        updateBatchSizeIfNeeded();
+        drainFifo();
+
+        // Woken early by configuration changes; otherwise poll at ~100 Hz
+        wait(10);
+    }
+}
+
+void SpectrumEngine::updatePlanIfNeeded()
+{
+    const int order = settings->fftOrder;
+    const auto windowType = settings->windowType;
+    const double sampleRate = requestedSampleRate.load();
+
+    if (plan != nullptr && plan->order == order && plan->windowType == windowType
+        && plan->sampleRate == sampleRate)
+        return;
+
+    // Build the replacement completely before it replaces the old one
+    auto newPlan = std::make_unique<SpectrumPlan>(order, windowType, sampleRate, numDisplayColumns);
+    plan = std::move(newPlan);
+    planChanged();
+}
+
+void SpectrumEngine::planChanged()
+{
+    samplesSinceLastFrame = 0;
+    numBatchedFrames = 0;
+
+    // Bin count changed, so the averages start again
+    for (auto& averager : averagers)
+        averager.prepare(plan->size / 2 + 1);
+
+    std::fill(longTermSum.begin(), longTermSum.end(), 0.0);
+    longTermFrames = 0;
+}
+
+//==============================================================================
+void SpectrumEngine::buildInlinePlan()
+{
+    // The plan the audio thread gave back last time can go now, which
+    // frees its slot for the next swap
+    delete retiredPlan.exchange(nullptr);
+
+    const auto& latest = settingsPublisher.getLatest();
+    inlinePlanOrder = latest.fftOrder;
+    inlinePlanWindow = latest.windowType;
+
+    auto* newPlan = new SpectrumPlan(inlinePlanOrder, inlinePlanWindow, requestedSampleRate.load(), numDisplayColumns);
+
+    // Replaces one the audio thread hasn't picked up yet
+    delete pendingPlan.exchange(newPlan);
+
+    // The smoother's band edges depend on the bin count
+    buildInlineSmoother();
+}
+
+void SpectrumEngine::buildInlineSmoother()
+{
+    delete retiredSmoother.exchange(nullptr);
+
+    inlineSmootherFraction = settingsPublisher.getLatest().smoothingFraction;
+
+    auto newSmoother = std::make_unique<SpectrumSmoother>();
+    newSmoother->prepare((1 << inlinePlanOrder) / 2 + 1, inlineSmootherFraction);
+    delete pendingSmoother.exchange(newSmoother.release());
+}
+
+bool SpectrumEngine::adoptInlinePlan()
+{
+    // Wait until the message thread has taken the previous plan back
+    if (retiredPlan.load() != nullptr)
+        return false;
+
+    auto* newPlan = pendingPlan.exchange(nullptr);
+
+    if (newPlan == nullptr)
+        return false;
+
+    retiredPlan.store(plan.release());
+    plan.reset(newPlan);
+
+    // planChanged() without the clearing, which the clearHistory step
+    // spreads over the following slices
+    samplesSinceLastFrame = 0;
+    numBatchedFrames = 0;
+    longTermFrames = 0;
+
+    for (auto& averager : averagers)
+        averager.setNumBins(plan->size / 2 + 1);
+
+    return true;
+}
+
+void SpectrumEngine::adoptInlineSmoother()
+{
+    if (retiredSmoother.load() != nullptr)
+        return;
+
+    if (auto* newSmoother = pendingSmoother.exchange(nullptr))
+    {
+        retiredSmoother.store(smoother.release());
+        smoother.reset(newSmoother);
+    }
+}
+
+void SpectrumEngine::analyseInline(double budgetSeconds)
+{
+    TRACKTWEAK_TRACE_SCOPE("analyseInline");
+    jassert(inlineMode);
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    const auto budget = static_cast<juce::int64>(budgetSeconds * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    // One slice whatever the budget, so analysis always moves forward
+    while (runInlineSlice() && juce::Time::getHighResolutionTicks() - start < budget)
+    {
+    }
+}
+
+bool SpectrumEngine::runInlineSlice()
+{
+    auto& frame = *plan->frameBuffers[0];
+    const int numBins = plan->size / 2 + 1;
+
+    // A stretch of the power separation; false once it reaches the last bin
+    auto separate = [&](auto separateRange)
+    {
+        const int end = juce::jmin(numBins, inlineCursor + inlineBinsPerSlice);
+        (this->*separateRange)(frame, inlineCursor, end, inlinePowerScale);
+        inlineCursor = end;
+        return end < numBins;
+    };
+
+    switch (inlineStep)
+    {
+        case InlineStep::clearHistory:
+        {
+            const int end = juce::jmin(numBins, inlineCursor + inlineBinsPerSlice);
+
+            for (auto& averager : averagers)
+                averager.clearBins(inlineCursor, end);
+
+            std::fill(longTermSum.begin() + inlineCursor, longTermSum.begin() + end, 0.0);
+            inlineCursor = end;
+
+            if (end == numBins)
+                inlineStep = InlineStep::drain;
+
+            return true;
+        }
+
+        case InlineStep::drain:
+            // Between frames is the only place the plan or settings change
+            settings.update();
+
+            if (adoptInlinePlan())
+            {
+                inlineCursor = 0;
+                inlineStep = InlineStep::clearHistory;
+                return true;
+            }
+
+            adoptInlineSmoother();
+
+            if (! drainUntilFrame())
+                return false;
+
+            inlineMidSide = settings->channelMode == ChannelMode::midSide;
+            inlinePowerScale = getPowerScale();
+            inlineStep = InlineStep::transformTrack;
+            return true;
+
+        case InlineStep::transformTrack:
+        {
+            TRACKTWEAK_TRACE_SCOPE("performFFT");
+
+            if (inlineMidSide)
+                convertToMidSide(frame);
+
+            transformPair(frame, frame.samples[0].data(), frame.samples[1].data(), frame.output->trackSpectrum.data());
+            inlineCursor = 0;
+            inlineStep = InlineStep::separateTrack;
+            return true;
+        }
+
+        case InlineStep::separateTrack:
+            if (! separate(&SpectrumEngine::separatePair))
+                inlineStep = frame.withReference ? InlineStep::transformReference : InlineStep::publish;
+
+            return true;
+
+        case InlineStep::transformReference:
+        {
+            TRACKTWEAK_TRACE_SCOPE("performFFT");
+            transformPair(frame, frame.samples[2].data(), frame.samples[3].data(), frame.referenceSpectrum.data());
+            inlineCursor = 0;
+            inlineStep = InlineStep::separateReference;
+            return true;
+        }
+
+        case InlineStep::separateReference:
+            if (! separate(&SpectrumEngine::separateReference))
+                inlineStep = InlineStep::publish;
+
+            return true;
+
+        case InlineStep::publish:
+            publishFrame(frame, inlineMidSide);
+            inlineCursor = 0;
+            inlineStep = InlineStep::display;
+            return true;
+
+        case InlineStep::display:
+        {
+            // One trace per slice; a trace the editor is reading is retried
+            bool published = true;
+
+            switch (inlineCursor)
+            {
+                case 0:  published = updateSpectrum(0); break;
+                case 1:  published = updateSpectrum(1); break;
+                case 2:  published = ! frame.withReference || updateReference(); break;
+                case 3:  published = updateLongTerm(); break;
+                default: notifyListener(); inlineStep = InlineStep::drain; break;
+            }
+
+            if (published)
+                ++inlineCursor;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Publisher>
+bool SpectrumEngine::publishDisplayData(Publisher&& publish)
+{
+    if (! inlineMode)
+    {
+        const juce::ScopedLock lock(spectrumDataMutex);
+        publish();
+        return true;
+    }
+
+    // The audio thread never waits for the editor
+    const juce::ScopedTryLock lock(spectrumDataMutex);
+
+    if (! lock.isLocked())
+        return false;
+
+    publish();
+    return true;
+}
+
+void SpectrumEngine::updateSmootherIfNeeded()
+{
+    const int numBins = plan->size / 2 + 1;
+    const int fraction = settings->smoothingFraction;
+
+    if (smoother->isPreparedFor(numBins, fraction))
+        return;
+
+    smoother->prepare(numBins, fraction);
+
+    for (auto& scratch : smoothedPower)
+        scratch.resize(static_cast<size_t>(numBins));
+}
+
+void SpectrumEngine::updateBatchSizeIfNeeded()
+{
+    const bool bulk = isBulkMode();
+    const size_t batchFrames = bulk ? bulkBatchFrames : 1;
+    auto& frameBuffers = plan->frameBuffers;
+
+    if (frameBuffers.size() == batchFrames)
+        return;
+
+    // Real time goes back to a single frame and frees the rest
+    frameBuffers.resize(juce::jmin(frameBuffers.size(), batchFrames));
+
+    while (frameBuffers.size() < batchFrames)
+        frameBuffers.push_back(std::make_unique<SpectrumPlan::FrameBuffers>(plan->order, plan->size));
+
+    // Helpers are kept once made; a host that rendered offline once will again
+    if (bulk && bulkPool == nullptr)
+    {
+        const int numHelpers = juce::jlimit(1, 7, juce::SystemStats::getNumCpus() - 1);
+        bulkPool = std::make_unique<juce::ThreadPool>(juce::ThreadPoolOptions{}
+                                                          .withThreadName("TrackTweak Bulk Analysis")
+                                                          .withNumberOfThreads(numHelpers));
+    }
+}
+
+const float* SpectrumEngine::smooth(const float* power, size_t scratch)
+{
+    // Inline, a new plan can run for a frame before its smoother arrives
+    if (! smoother->isActive() || smoother->getNumBins() != plan->size / 2 + 1)
+        return power;
+
+    smoother->process(power, smoothedPower[scratch].data());
+    return smoothedPower[scratch].data();
+}
+
+void SpectrumEngine::drainFifo()
+{
+    const int hop = plan->size / 2;
+
+    // Copies run up to the next frame or the end of the data, whichever
+    // comes first
+    auto consume = [this, hop](int start, int count)
+    {
+        while (count > 0)
+        {
+            const int untilFrame = juce::jmax(1, hop - samplesSinceLastFrame, plan->size - validSamples);
+            const int run = juce::jmin(count, untilFrame);
+
+            appendToHistory(start, run);
+            start += run;
+            count -= run;
+
+            // 50% overlap between frames
+            // (a hop is skipped if views are holding every bus frame)
+            if (samplesSinceLastFrame >= hop && validSamples >= plan->size)
+            {
+                samplesSinceLastFrame = 0;
+
+                if (captureFrame(*plan->frameBuffers[static_cast<size_t>(numBatchedFrames)])
+                    && ++numBatchedFrames == static_cast<int>(plan->frameBuffers.size()))
+                    analyseBatch();
+            }
+        }
+    };
+
+    {
+        const auto scope = abstractFifo.read(abstractFifo.getNumReady());
+        consume(scope.startIndex1, scope.blockSize1);
+        consume(scope.startIndex2, scope.blockSize2);
+    }
+
+    // Whatever is left of a batch goes now rather than waiting for more data
+    if (numBatchedFrames > 0)
+        analyseBatch();
+
+    fifoSpaceAvailable.signal();
+}
+
+void SpectrumEngine::appendToHistory(int fifoStart, int count)
+{
+    const int historySize = static_cast<int>(history[0].size());
+
+    while (count > 0)
+    {
+        const int run = juce::jmin(count, historySize - historyWritePos);
+
+        for (size_t channel = 0; channel < history.size(); ++channel)
+            std::copy_n(fifoBuffers[channel].data() + fifoStart, run, history[channel].data() + historyWritePos);
+
+        historyWritePos = (historyWritePos + run) % historySize;
+        validSamples = juce::jmin(validSamples + run, historySize);
+        samplesSinceLastFrame += run;
+        fifoStart += run;
+        count -= run;
+    }
+}
+
+bool SpectrumEngine::drainUntilFrame()
+{
+    // Reads no further than the next frame, so the ring keeps the rest
+    const int hop = plan->size / 2;
+    const int untilFrame = juce::jmax(1, hop - samplesSinceLastFrame, plan->size - validSamples);
+
+    {
+        const auto scope = abstractFifo.read(juce::jmin(untilFrame, abstractFifo.getNumReady()));
+        appendToHistory(scope.startIndex1, scope.blockSize1);
+        appendToHistory(scope.startIndex2, scope.blockSize2);
+    }
+
+    if (samplesSinceLastFrame < hop || validSamples < plan->size)
+        return false;
+
+    samplesSinceLastFrame = 0;
+    return captureFrame(*plan->frameBuffers[0]);
+}
+
+bool SpectrumEngine::captureFrame(SpectrumPlan::FrameBuffers& frame)
+{
+    const int size = plan->size;
+    frame.output = frameBus.acquire(size);
+
+    if (! frame.output)
+        return false;
+
+    const int historySize = static_cast<int>(history[0].size());
+    const int start = (historyWritePos - size + historySize) % historySize;
+    const int firstPart = juce::jmin(size, historySize - start);
+
+    // Read once here: the frame is analysed and published as captured,
+    // whatever the reference bus does in the meantime
+    frame.withReference = hasReference();
+    const size_t numChannels = frame.withReference ? history.size() : 2;
+
+    // Unwrap the newest 'size' samples of each channel
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = frame.samples[channel].data();
+        std::copy_n(history[channel].data() + start, firstPart, samples);
+        std::copy_n(history[channel].data(), size - firstPart, samples + firstPart);
+    }
+
+    return true;
+}
+
+void SpectrumEngine::analyseBatch()
+{
+    TRACKTWEAK_TRACE_SCOPE("analyseBatch");
+    const int numFrames = numBatchedFrames;
+    numBatchedFrames = 0;
+    const bool midSide = settings->channelMode == ChannelMode::midSide;
+    const float powerScale = getPowerScale();
+
+    // Frames are independent until they reach the averagers: helpers and
+    // this thread take them in turn
+    nextBatchFrame.store(0);
+
+    auto analyseFrames = [this, numFrames, midSide, powerScale]
+    {
+        for (int i = nextBatchFrame++; i < numFrames; i = nextBatchFrame++)
+            analyseFrame(*plan->frameBuffers[static_cast<size_t>(i)], midSide, powerScale);
+    };
+
+    const int numHelpers = bulkPool != nullptr ? juce::jmin(bulkPool->getNumThreads(), numFrames - 1) : 0;
+    pendingHelpers.store(numHelpers);
+
+    for (int i = 0; i < numHelpers; ++i)
+    {
+        bulkPool->addJob([this, analyseFrames]
+        {
+            analyseFrames();
+
+            if (--pendingHelpers == 0)
+                helpersFinished.signal();
+        });
+    }
+
+    analyseFrames();
+
+    if (numHelpers > 0)
+        helpersFinished.wait();
+
+    // Consumers (averaging among them) are order dependent, so frames are
+    // published in hop order from this thread
+    bool withReference = false;
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        auto& frame = *plan->frameBuffers[static_cast<size_t>(i)];
+        withReference = withReference || frame.withReference;
+        publishFrame(frame, midSide);
+    }
+
+    updateSpectrum(0);
+    updateSpectrum(1);
+
+    if (withReference)
+        updateReference();
+
+    updateLongTerm();
+    notifyListener();
+}
+
+float SpectrumEngine::getPowerScale() const
+{
+    return 0.25f * plan->amplitudeScale * plan->amplitudeScale
+         / (settings->noiseCalibration ? plan->enbwBins : 1.0f);
+}
+
+void SpectrumEngine::notifyListener()
+{
+    // Only this thread writes the display data, so it can be read unlocked here
+    const juce::SpinLock::ScopedLockType lock(listenerLock);
+    if (frameListener != nullptr)
+        frameListener->spectrumFrameAnalysed(spectrumMagnitudes[0][static_cast<size_t>(TraceKind::average)].data(),
+                                             numDisplayColumns, settings.get());
+}
+
+void SpectrumEngine::analyseFrame(SpectrumPlan::FrameBuffers& frame, bool midSide, float powerScale) const
+{
+    TRACKTWEAK_TRACE_SCOPE("performFFT");
+    const int numBins = plan->size / 2 + 1;
+
+    if (midSide)
+        convertToMidSide(frame);
+
+    transformPair(frame, frame.samples[0].data(), frame.samples[1].data(), frame.output->trackSpectrum.data());
+    separatePair(frame, 0, numBins, powerScale);
+
+    // Second transform of the same hop for the reference pair
+    if (frame.withReference)
+    {
+        transformPair(frame, frame.samples[2].data(), frame.samples[3].data(), frame.referenceSpectrum.data());
+        separateReference(frame, 0, numBins, powerScale);
+    }
+}
+
+void SpectrumEngine::convertToMidSide(SpectrumPlan::FrameBuffers& frame) const
+{
+    // mid = (L + R) / 2, side = (L - R) / 2
+    const int size = plan->size;
+    auto* first = frame.samples[0].data();
+    auto* second = frame.samples[1].data();
+
+    juce::FloatVectorOperations::subtract(second, first, second, size);
+    juce::FloatVectorOperations::multiply(second, 0.5f, size);
+    juce::FloatVectorOperations::subtract(first, second, size);
+}
+
+void SpectrumEngine::separatePair(SpectrumPlan::FrameBuffers& frame, int firstBin, int endBin, float powerScale) const
+{
+    // Conjugate symmetry separates the two real spectra:
+    // A[k] = (Z[k] + Z*[N-k]) / 2,  B[k] = (Z[k] - Z*[N-k]) / 2j
+    // Only power is needed, so |.|^2 avoids a square root per bin
+    const int size = plan->size;
+    const auto* z = frame.output->trackSpectrum.data();
+    auto* powerA = frame.output->power[0].data();
+    auto* powerB = frame.output->power[1].data();
+
+    for (int k = firstBin; k < endBin; ++k)
+    {
+        const auto zk = z[k];
+        const auto zn = std::conj(z[(size - k) & (size - 1)]);
+
+        powerA[k] = powerScale * std::norm(zk + zn);
+        powerB[k] = powerScale * std::norm(zk - zn);
+    }
+}
+
+void SpectrumEngine::separateReference(SpectrumPlan::FrameBuffers& frame, int firstBin, int endBin, float powerScale) const
+{
+    // As separatePair, folded straight into the mean power of the two
+    // reference channels
+    const int size = plan->size;
+    const auto* z = frame.referenceSpectrum.data();
+    auto* powerReference = frame.output->power[2].data();
+    const float meanScale = 0.5f * powerScale;
+
+    for (int k = firstBin; k < endBin; ++k)
+    {
+        const auto zk = z[k];
+        const auto zn = std::conj(z[(size - k) & (size - 1)]);
+
+        powerReference[k] = meanScale * (std::norm(zk + zn) + std::norm(zk - zn));
+    }
+}
+
+void SpectrumEngine::publishFrame(SpectrumPlan::FrameBuffers& frame, bool midSide)
+{
+    auto& output = *frame.output;
+    output.sampleRate = plan->sampleRate;
+    output.midSide = midSide;
+    output.hasReference = frame.withReference;
+
+    frameBus.publish(output);
+
+    // Back to the pool, unless a view kept it
+    frame.output = {};
+}
+
+void SpectrumEngine::spectrumFrameReady(const SpectrumFrame& frame)
+{
+    // Linear-power averaging over the whole bin array
+    const auto mode = settings->averagingMode;
+    const float weight = settings->averagingWeight;
+    const int frames = settings->rmsLength;
+    const float decay = settings->peakDecay;
+    const float frameInterval = static_cast<float>((frame.fftSize / 2) / frame.sampleRate);
+    const bool resetMaxHold = maxHoldResetRequested.exchange(false);
+
+    for (size_t trace = 0; trace < static_cast<size_t>(numTraces); ++trace)
+    {
+        if (resetMaxHold)
+            averagers[trace].resetMaxHold();
+
+        averagers[trace].addFrame(frame.power[trace].data(), mode, weight, frames, decay, frameInterval);
+    }
+
+    if (frame.hasReference)
+        averagers[referenceAverager].addFrame(frame.power[2].data(), mode, weight, frames, decay, frameInterval);
+
+    // Long-term average of the track's mean power; (L + R) / 2 or M + S
+    const int numBins = frame.numBins;
+
+    if (longTermResetRequested.exchange(false))
+    {
+        std::fill_n(longTermSum.begin(), numBins, 0.0);
+        longTermFrames = 0;
+    }
+
+    if (longTermRunning.load())
+    {
+        const double scale = frame.midSide ? 1.0 : 0.5;
+        const float* powerA = frame.power[0].data();
+        const float* powerB = frame.power[1].data();
+        double* sum = longTermSum.data();
+
+        // Simple enough for the compiler to vectorise (convert and add)
+        for (int k = 0; k < numBins; ++k)
+            sum[k] += scale * (static_cast<double>(powerA[k]) + static_cast<double>(powerB[k]));
+
+        ++longTermFrames;
+    }
+}
+
+bool SpectrumEngine::updateLongTerm()
+{
+    TRACKTWEAK_TRACE_SCOPE("updateLongTerm");
+
+    if (longTermFrames == 0)
+        return true;
+
+    const int numBins = plan->size / 2 + 1;
+    const double scale = 1.0 / static_cast<double>(longTermFrames);
+
+    for (int k = 0; k < numBins; ++k)
+        longTermPower[static_cast<size_t>(k)] = static_cast<float>(longTermSum[static_cast<size_t>(k)] * scale);
+
+    const auto* power = smooth(longTermPower.data(), 0);
+    auto* columns = columnScratch[0].data();
+
+    for (size_t i = 0; i < static_cast<size_t>(numDisplayColumns); ++i)
+        columns[i] = getColumnPower(power, i);
+
+    DecibelConversion::powerToDecibels(columns, columns, numDisplayColumns);
+
+    return publishDisplayData([this, columns] { publishLongTerm(columns); });
+}
+
+void SpectrumEngine::publishLongTerm(const float* columns)
+{
+    juce::FloatVectorOperations::copy(longTermMagnitudes.data(), columns, numDisplayColumns);
+    hasLongTermData = true;
+
+    if (settings->targetCurve == SpectrumTargets::Genre::none)
+        return;
+
+    // Move the target to the average's level over 100 Hz - 10 kHz, where
+    // the curves are most reliable
+    const auto lastColumn = static_cast<float>(numDisplayColumns - 1);
+    const int first = juce::roundToInt(frequencyToDisplayPosition(100.0f) * lastColumn);
+    const int last = juce::roundToInt(frequencyToDisplayPosition(10000.0f) * lastColumn);
+    float offset = 0.0f;
+
+    for (int i = first; i <= last; ++i)
+        offset += columns[i] - targetCentre[static_cast<size_t>(i)];
+
+    offset /= static_cast<float>(last - first + 1);
+
+    juce::FloatVectorOperations::add(targetLow.data(), targetCentre.data(), offset, numDisplayColumns);
+    juce::FloatVectorOperations::subtract(targetLow.data(), targetTolerance.data(), numDisplayColumns);
+    juce::FloatVectorOperations::add(targetHigh.data(), targetCentre.data(), offset, numDisplayColumns);
+    juce::FloatVectorOperations::add(targetHigh.data(), targetTolerance.data(), numDisplayColumns);
+}
+
+bool SpectrumEngine::getLongTermData(std::vector<float>& average, std::vector<float>& low, std::vector<float>& high)
+{
+    const juce::ScopedLock lock(spectrumDataMutex);
+    average = longTermMagnitudes;
+    low = targetLow;
+    high = targetHigh;
+    return hasLongTermData;
+}
+
+void SpectrumEngine::transformPair(SpectrumPlan::FrameBuffers& frame, float* first, float* second,
+                                   std::complex<float>* destination) const
+{
+    const int size = plan->size;
+
+    juce::FloatVectorOperations::multiply(first, plan->window.data(), size);
+    juce::FloatVectorOperations::multiply(second, plan->window.data(), size);
+
+    // Pack z[n] = a[n] + j.b[n] and run one complex transform for both
+    auto* timeData = frame.timeData.data();
+    for (int i = 0; i < size; ++i)
+        timeData[i] = { first[i], second[i] };
+
+    frame.fft.perform(timeData, destination, false);
+}
+
+bool SpectrumEngine::updateSpectrum(int trace)
+{
+    TRACKTWEAK_TRACE_SCOPE("updateSpectrum");
+    const auto& averager = averagers[static_cast<size_t>(trace)];
+    const std::array<const float*, numTraceKinds> sources{ averager.getAverage(), averager.getPeakHold(), averager.getMaxHold() };
+
+    // One dB conversion per display column, not per bin, done a whole trace
+    // at a time outside the lock
+    for (size_t kind = 0; kind < sources.size(); ++kind)
+    {
+        auto* columns = columnScratch[kind].data();
+        const auto* power = smooth(sources[kind], 0);
+
+        for (size_t i = 0; i < static_cast<size_t>(numDisplayColumns); ++i)
+            columns[i] = getColumnPower(power, i);
+
+        DecibelConversion::powerToDecibels(columns, columns, numDisplayColumns, settings->displayFloor);
+    }
+
+    const float floordB = settings->displayFloor, ceilingdB = settings->displayCeiling;
+
+    return publishDisplayData([&]
+    {
+        for (size_t kind = 0; kind < sources.size(); ++kind)
+            juce::FloatVectorOperations::clip(spectrumMagnitudes[static_cast<size_t>(trace)][kind].data(),
+                                              columnScratch[kind].data(), floordB, ceilingdB, numDisplayColumns);
+    });
+}
+
+float SpectrumEngine::getColumnPower(const float* power, size_t column) const
+{
+    const int start = plan->binStart[column];
+    const int end = plan->binEnd[column];
+
+    if (end == start)
+        return power[start] + plan->binFraction[column] * (power[start + 1] - power[start]);
+
+    float result = 0.0f;
+    for (int bin = start; bin < end; ++bin)
+        result = juce::jmax(result, power[bin]);
+
+    return result;
+}
+
+bool SpectrumEngine::updateReference()
+{
+    TRACKTWEAK_TRACE_SCOPE("updateReference");
+
+    const int numBins = plan->size / 2 + 1;
+    auto* trackMean = plan->trackMeanPower.data();
+
+    // Averaging is linear, so the track's mean power comes straight from the
+    // two averaged traces: (L + R) / 2, or M + S which is the same thing
+    juce::FloatVectorOperations::add(trackMean, averagers[0].getAverage(), averagers[1].getAverage(), numBins);
+    if (settings->channelMode == ChannelMode::leftRight)
+        juce::FloatVectorOperations::multiply(trackMean, 0.5f, numBins);
+
+    const auto* reference = smooth(averagers[referenceAverager].getAverage(), 0);
+    const auto* track = smooth(trackMean, 1);
+    auto* referencedB = columnScratch[0].data();
+    auto* trackdB = columnScratch[1].data();
+
+    for (size_t i = 0; i < static_cast<size_t>(numDisplayColumns); ++i)
+    {
+        referencedB[i] = getColumnPower(reference, i);
+        trackdB[i] = getColumnPower(track, i);
+    }
+
+    DecibelConversion::powerToDecibels(referencedB, referencedB, numDisplayColumns);
+    DecibelConversion::powerToDecibels(trackdB, trackdB, numDisplayColumns);
+
+    return publishDisplayData([&]
+    {
+        juce::FloatVectorOperations::clip(referenceMagnitudes.data(), referencedB,
+                                          settings->displayFloor, settings->displayCeiling, numDisplayColumns);
+        juce::FloatVectorOperations::subtract(differenceMagnitudes.data(), trackdB, referencedB, numDisplayColumns);
+    });
+}
+
+void SpectrumEngine::getReferenceData(std::vector<float>& reference, std::vector<float>& difference)
+{
+    const juce::ScopedLock lock(spectrumDataMutex);
+    reference = referenceMagnitudes;
+    difference = differenceMagnitudes;
+}
+
+void SpectrumEngine::getDisplayData(std::vector<float>& destination, int trace, TraceKind kind)
+{
+    TRACKTWEAK_TRACE_SCOPE("getDisplayData");
+    const juce::ScopedLock lock(spectrumDataMutex);
+    destination = spectrumMagnitudes[static_cast<size_t>(juce::jlimit(0, numTraces - 1, trace))]
+                                    [static_cast<size_t>(kind)];
+}
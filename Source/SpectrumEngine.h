@@ -0,0 +1,396 @@
+/*
+  ==============================================================================
+    Background spectrum analysis: FFT plans, window tables and display mapping.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "AnalyzerSettings.h"
+#include "SpectrumAverager.h"
+#include "SpectrumFrameBus.h"
+#include "SpectrumSmoother.h"
+#include "SpectrumTargets.h"
+
+// Build with TRACKTWEAK_INLINE_ANALYSIS=1 for hosts that don't let a plugin
+// run threads of its own: the spectrum is then analysed on the audio thread
+// in budgeted slices (see SpectrumEngine::analyseInline).
+#ifndef TRACKTWEAK_INLINE_ANALYSIS
+ #define TRACKTWEAK_INLINE_ANALYSIS 0
+#endif
+
+//==============================================================================
+// Everything that depends on the FFT size, window and sample rate. A plan is
+// built in one go on the analysis worker and never modified afterwards,
+// apart from its frame buffers which only the worker (and, in bulk mode, its
+// helpers) touch.
+struct SpectrumPlan
+{
+    using WindowType = AnalyzerSettings::WindowType;
+
+    SpectrumPlan(int fftOrder, WindowType type, double sampleRate, int numDisplayPoints);
+
+    const int order;
+    const int size;
+    const WindowType windowType;
+    const double sampleRate;
+
+    std::vector<float> window;
+
+    // A full-scale sine peaks at 1.0 after amplitudeScale; dividing power by
+    // enbwBins reads broadband noise at the same level whatever the window
+    float amplitudeScale = 1.0f;
+    float enbwBins = 1.0f;
+
+    // Log-frequency display columns: max over [binStart, binEnd), or a linear
+    // interpolation at binStart + fraction when the column is narrower than a bin
+    std::vector<int> binStart, binEnd;
+    std::vector<float> binFraction;
+
+    // Working set for one analysis frame. Two real channels share one
+    // complex transform: a + j.b in, separated afterwards into calibrated
+    // power. Samples are the track pair then the reference pair. The track
+    // transform and the power go straight into the bus frame acquired at
+    // capture; the reference transform only lives here. Each has its own
+    // FFT engine, so frames can be transformed on different threads.
+    struct FrameBuffers
+    {
+        FrameBuffers(int fftOrder, int size);
+
+        juce::dsp::FFT fft;
+        std::vector<std::complex<float>> timeData, referenceSpectrum;
+        std::array<std::vector<float>, 4> samples;
+        SpectrumFrame::Ptr output;
+        bool withReference = false;     // whether samples[2..3] were captured
+    };
+
+    // One in real time; a batch in bulk mode
+    std::vector<std::unique_ptr<FrameBuffers>> frameBuffers;
+    std::vector<float> trackMeanPower;
+
+    static constexpr float minDisplayFrequency = 20.0f;
+    static constexpr float maxDisplayFrequency = 20000.0f;
+};
+
+//==============================================================================
+// Owns the analysis worker. The audio thread only writes into a fixed ring
+// buffer; the worker frames, windows and transforms the data and rebuilds
+// its plan when the FFT size, window or sample rate changes, so switching
+// never allocates or blocks on the audio thread. Settings come from the
+// processor's published snapshots: the analysis thread picks up a new one
+// with a single pointer load per pass, so automation costs nothing here
+// until a value actually changes.
+//
+// Each hop is transformed once, into a frame from the frame bus, and every
+// spectral view reads that frame: the engine's own averaging and long-term
+// average are just the first consumer, so adding views adds no FFTs.
+//
+// Bulk mode is for offline renders, where the host runs as fast as we let
+// it: the audio thread waits for ring space instead of dropping samples, so
+// every hop is analysed, and the worker transforms a batch of frames at a
+// time across a small thread pool. The display and frame listener are then
+// only updated once per batch.
+//
+// Inline mode has no worker at all. Each frame's work is split into
+// resumable slices - drain and capture, one FFT, a stretch of bins of the
+// power separation, the averaging, each display trace - and the audio
+// thread runs slices after each callback until its time budget is spent,
+// so a frame's cost spreads over as many callbacks as it needs. The worst
+// callback then costs the budget plus one slice (at most one FFT), not a
+// whole frame. Plans are built on the message thread and handed over with
+// an atomic exchange, together with their smoother tables; the averagers
+// are sized for the largest FFT up front, so nothing allocates on the
+// audio thread, and clearing them after a plan change is sliced too.
+class SpectrumEngine : private juce::Thread,
+                       private SpectrumFrameBus::Consumer
+{
+public:
+    using WindowType = SpectrumPlan::WindowType;
+
+    // Which pair of signals the two traces show
+    using ChannelMode = AnalyzerSettings::ChannelMode;
+    static constexpr int numTraces = 2;
+    static constexpr int numInputChannels = 4; // track L/R, reference L/R
+
+    // What each trace can show
+    enum class TraceKind { average = 0, peakHold, maxHold };
+    static constexpr int numTraceKinds = 3;
+
+    using AveragingMode = SpectrumAverager::Mode;
+
+    static constexpr int minFFTOrder = AnalyzerSettings::minFFTOrder;
+    static constexpr int maxFFTOrder = AnalyzerSettings::maxFFTOrder;
+
+    SpectrumEngine(int numDisplayPoints, AnalyzerSettingsPublisher& settingsPublisher, bool analyseOnAudioThread = false);
+    ~SpectrumEngine() override;
+
+    bool isInline() const { return inlineMode; }
+
+    // Audio thread, inline mode, once per callback: runs analysis slices
+    // until budgetSeconds have passed (at least one, if there is work)
+    void analyseInline(double budgetSeconds);
+
+    void prepare(double sampleRate);
+
+    // Audio thread: lock-free, samples are dropped if the worker falls behind
+    // (in bulk mode it waits instead). Pass nullptr for 'right' on a mono
+    // input, and for both reference pointers when there is no sidechain.
+    // Track and reference share one ring so their frames stay sample-aligned.
+    template <typename SampleType>
+    void pushSamples(const SampleType* left, const SampleType* right,
+                     const SampleType* referenceLeft, const SampleType* referenceRight, int numSamples);
+
+    // Audio thread, once per block: whether the host is rendering offline
+    // (ignored inline, where there is no worker to wait for)
+    void setBulkMode(bool shouldUseBulkMode);
+    bool isBulkMode() const { return bulkMode.load(std::memory_order_relaxed); }
+
+    // Message thread, after new settings are published. A new FFT size or
+    // window is built and swapped in by the worker (inline, built here and
+    // swapped in by the audio thread between frames); the target curve is
+    // mapped onto the display columns here.
+    void settingsChanged();
+
+    void resetMaxHold() { maxHoldResetRequested.store(true); }
+
+    // Long-term average spectrum of the track: accumulates for the whole
+    // session, or from a reset for as long as it is left running
+    void resetLongTermAverage() { longTermResetRequested.store(true); }
+    void setLongTermAverageRunning(bool shouldRun) { longTermRunning.store(shouldRun); }
+
+    // Told about every analysed frame, on the worker (inline, the audio
+    // thread), with the averaged first trace in dB per display column. Keep
+    // the callback short.
+    struct FrameListener
+    {
+        virtual ~FrameListener() = default;
+        virtual void spectrumFrameAnalysed(const float* decibels, int numColumns, const AnalyzerSettings& settings) = 0;
+    };
+
+    // Once cleared, the listener is guaranteed not to be called again
+    void setFrameListener(FrameListener* newListener);
+
+    // Every analysed hop, before any averaging, for views of their own
+    SpectrumFrameBus& getFrameBus() { return frameBus; }
+
+    bool isStereo() const { return stereoInput.load(); }
+    bool hasReference() const { return referenceInput.load(); }
+
+    // GUI: latest trace in dB, one value per display column. Trace 0 is
+    // left (or mid), trace 1 right (or side).
+    void getDisplayData(std::vector<float>& destination, int trace, TraceKind kind = TraceKind::average);
+
+    // GUI: averaged reference trace and track-minus-reference difference,
+    // both in dB per display column and not level matched
+    void getReferenceData(std::vector<float>& reference, std::vector<float>& difference);
+
+    // GUI: long-term average in dB per display column, and the target band
+    // moved to the same level. False until something has been accumulated.
+    bool getLongTermData(std::vector<float>& average, std::vector<float>& targetLow, std::vector<float>& targetHigh);
+
+    // Maps a frequency to the 0..1 horizontal position used by the display columns
+    static float frequencyToDisplayPosition(float frequency);
+
+private:
+    void run() override;
+    void updatePlanIfNeeded();
+    void planChanged();
+    void buildInlinePlan();
+    void buildInlineSmoother();
+    bool adoptInlinePlan();
+    void adoptInlineSmoother();
+    bool runInlineSlice();
+    void updateSmootherIfNeeded();
+    void updateBatchSizeIfNeeded();
+    const float* smooth(const float* power, size_t scratch);
+    void drainFifo();
+    void appendToHistory(int fifoStart, int count);
+    bool drainUntilFrame();
+    bool captureFrame(SpectrumPlan::FrameBuffers& frame);
+    void analyseBatch();
+    void analyseFrame(SpectrumPlan::FrameBuffers& frame, bool midSide, float powerScale) const;
+    void transformPair(SpectrumPlan::FrameBuffers& frame, float* first, float* second,
+                       std::complex<float>* destination) const;
+    void convertToMidSide(SpectrumPlan::FrameBuffers& frame) const;
+    void separatePair(SpectrumPlan::FrameBuffers& frame, int firstBin, int endBin, float powerScale) const;
+    void separateReference(SpectrumPlan::FrameBuffers& frame, int firstBin, int endBin, float powerScale) const;
+    float getPowerScale() const;
+    void publishFrame(SpectrumPlan::FrameBuffers& frame, bool midSide);
+    void spectrumFrameReady(const SpectrumFrame& frame) override;
+
+    template <typename SampleType>
+    void writeToFifo(const SampleType* left, const SampleType* right,
+                     const SampleType* referenceLeft, const SampleType* referenceRight, int numSamples);
+
+    // Each maps its averages to display columns and publishes them; false
+    // when inline and the editor held the display data
+    bool updateSpectrum(int trace);
+    bool updateReference();
+    bool updateLongTerm();
+    void publishLongTerm(const float* columns);
+    void notifyListener();
+
+    template <typename Publisher>
+    bool publishDisplayData(Publisher&& publish);
+    float getColumnPower(const float* power, size_t column) const;
+
+    const int numDisplayColumns;
+
+    // Audio -> worker ring
+    static constexpr int fifoSize = 1 << (maxFFTOrder + 2);
+    juce::AbstractFifo abstractFifo{ fifoSize };
+    std::array<std::vector<float>, numInputChannels> fifoBuffers;
+    std::atomic<bool> stereoInput{ false };
+    std::atomic<bool> referenceInput{ false };
+    std::atomic<bool> bulkMode{ false };
+    juce::WaitableEvent fifoSpaceAvailable;
+
+    // Worker-owned sliding analysis window (sized for the largest FFT)
+    std::array<std::vector<float>, numInputChannels> history;
+    int historyWritePos = 0;
+    int samplesSinceLastFrame = 0;
+    int validSamples = 0;
+
+    // Frames captured but not yet analysed; helpers join in bulk mode
+    static constexpr int bulkBatchFrames = 16;
+    int numBatchedFrames = 0;
+    std::unique_ptr<juce::ThreadPool> bulkPool;
+    std::atomic<int> nextBatchFrame{ 0 }, pendingHelpers{ 0 };
+    juce::WaitableEvent helpersFinished;
+
+    // The plan's frame buffers can still hold bus frames, so the plan has
+    // to go first
+    SpectrumFrameBus frameBus;
+    std::unique_ptr<SpectrumPlan> plan;
+
+    // The analysis thread's view of the settings, and what the message
+    // thread last built an inline plan for
+    AnalyzerSettingsPublisher& settingsPublisher;
+    AnalyzerSettingsPublisher::Reader settings{ settingsPublisher };
+    int inlinePlanOrder = 0;
+    WindowType inlinePlanWindow = WindowType::hann;
+    int inlineSmootherFraction = -1;
+    SpectrumTargets::Genre mappedTarget = SpectrumTargets::Genre::none;
+
+    // Inline mode: message thread -> audio thread plan handoff, and where the
+    // audio thread is in the current frame
+    const bool inlineMode;
+    std::atomic<SpectrumPlan*> pendingPlan{ nullptr };
+    std::atomic<SpectrumPlan*> retiredPlan{ nullptr };
+    std::atomic<SpectrumSmoother*> pendingSmoother{ nullptr };
+    std::atomic<SpectrumSmoother*> retiredSmoother{ nullptr };
+
+    // clearHistory runs after a new plan is adopted: the averages and the
+    // long-term sum start again a stretch of bins per slice
+    enum class InlineStep { clearHistory, drain, transformTrack, separateTrack, transformReference, separateReference,
+                            publish, display };
+    static constexpr int inlineBinsPerSlice = 2048;
+    InlineStep inlineStep = InlineStep::drain;
+    int inlineCursor = 0;
+    bool inlineMidSide = false;
+    float inlinePowerScale = 1.0f;
+
+    std::atomic<double> requestedSampleRate{ 44100.0 };
+
+    // Averaging runs in linear power on the worker, as a bus consumer; the
+    // last one is the reference
+    static constexpr int referenceAverager = numTraces;
+    std::array<SpectrumAverager, numTraces + 1> averagers;
+    std::atomic<bool> maxHoldResetRequested{ false };
+
+    // Worker-only (inline, swapped in by the audio thread); two scratch
+    // spectra since the reference maps two at once
+    std::unique_ptr<SpectrumSmoother> smoother = std::make_unique<SpectrumSmoother>();
+    std::array<std::vector<float>, 2> smoothedPower;
+
+    // Long-term average: a double sum per bin, sized for the largest FFT once
+    std::vector<double> longTermSum;
+    std::vector<float> longTermPower;
+    juce::int64 longTermFrames = 0;
+    std::atomic<bool> longTermResetRequested{ false };
+    std::atomic<bool> longTermRunning{ true };
+
+    juce::SpinLock listenerLock;
+    FrameListener* frameListener = nullptr;
+
+    // dB per display column, indexed [trace][kind]
+    juce::CriticalSection spectrumDataMutex;
+    std::array<std::array<std::vector<float>, numTraceKinds>, numTraces> spectrumMagnitudes;
+    std::vector<float> referenceMagnitudes, differenceMagnitudes;
+    std::vector<float> longTermMagnitudes, targetCentre, targetTolerance, targetLow, targetHigh;
+    bool hasLongTermData = false;
+
+    // Worker-only per-column power / dB, one array per trace kind
+    std::array<std::vector<float>, numTraceKinds> columnScratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumEngine)
+};
+
+//==============================================================================
+template <typename SampleType>
+void SpectrumEngine::pushSamples(const SampleType* left, const SampleType* right,
+                                 const SampleType* referenceLeft, const SampleType* referenceRight, int numSamples)
+{
+    stereoInput.store(right != nullptr, std::memory_order_relaxed);
+    referenceInput.store(referenceLeft != nullptr, std::memory_order_relaxed);
+
+    if (! isBulkMode())
+    {
+        writeToFifo(left, right, referenceLeft, referenceRight, numSamples);
+        return;
+    }
+
+    // Offline the host waits for us anyway, so hand everything over in
+    // pieces, waiting for the worker to make room
+    for (int done = 0; done < numSamples;)
+    {
+        const int count = juce::jmin(numSamples - done, fifoSize / 4);
+
+        while (abstractFifo.getFreeSpace() < count && isThreadRunning())
+        {
+            notify();
+            fifoSpaceAvailable.wait(5);
+        }
+
+        auto offset = [done](const SampleType* channel) { return channel != nullptr ? channel + done : nullptr; };
+        writeToFifo(left + done, offset(right), offset(referenceLeft), offset(referenceRight), count);
+        done += count;
+    }
+
+    notify();
+}
+
+template <typename SampleType>
+void SpectrumEngine::writeToFifo(const SampleType* left, const SampleType* right,
+                                 const SampleType* referenceLeft, const SampleType* referenceRight, int numSamples)
+{
+    if (right == nullptr)
+        right = left;
+
+    if (referenceRight == nullptr)
+        referenceRight = referenceLeft;
+
+    const std::array<const SampleType*, numInputChannels> sources{ left, right, referenceLeft, referenceRight };
+    const auto scope = abstractFifo.write(numSamples);
+
+    for (size_t channel = 0; channel < sources.size(); ++channel)
+    {
+        auto* fifo = fifoBuffers[channel].data();
+        const auto* source = sources[channel];
+
+        // No sidechain: keep the reference lanes silent so they stay aligned
+        if (source == nullptr)
+        {
+            std::fill_n(fifo + scope.startIndex1, scope.blockSize1, 0.0f);
+            std::fill_n(fifo + scope.startIndex2, scope.blockSize2, 0.0f);
+            continue;
+        }
+
+        for (int i = 0; i < scope.blockSize1; ++i)
+            fifo[scope.startIndex1 + i] = static_cast<float>(source[i]);
+
+        for (int i = 0; i < scope.blockSize2; ++i)
+            fifo[scope.startIndex2 + i] = static_cast<float>(source[scope.blockSize1 + i]);
+    }
+}
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+    Analysed spectrum frames, transformed once per hop and shared by every
+    spectral view.
+  ==============================================================================
+*/
+
+#include "SpectrumFrameBus.h"
+
+//==============================================================================
+void SpectrumFrame::Ptr::retain() noexcept
+{
+    if (frame != nullptr)
+        frame->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SpectrumFrame::Ptr::release() noexcept
+{
+    // Zero is what makes the frame free again, so the writes of whoever
+    // acquires it next must not move ahead of our last read
+    if (frame != nullptr)
+        frame->references.fetch_sub(1, std::memory_order_release);
+
+    frame = nullptr;
+}
+
+SpectrumFrame::Ptr SpectrumFrame::retain() const noexcept
+{
+    references.fetch_add(1, std::memory_order_relaxed);
+    return Ptr(const_cast<SpectrumFrame*>(this));
+}
+
+std::complex<float> SpectrumFrame::getTrackBin(int channel, int k) const noexcept
+{
+    // A[k] = (Z[k] + Z*[N-k]) / 2,  B[k] = (Z[k] - Z*[N-k]) / 2j
+    const auto zk = trackSpectrum[static_cast<size_t>(k)];
+    const auto zn = std::conj(trackSpectrum[static_cast<size_t>((fftSize - k) & (fftSize - 1))]);
+
+    return channel == 0 ? 0.5f * (zk + zn) : std::complex<float>(0.0f, -0.5f) * (zk - zn);
+}
+
+//==============================================================================
+SpectrumFrameBus::SpectrumFrameBus()
+{
+    for (auto& frame : pool)
+        frame = std::make_unique<SpectrumFrame>();
+}
+
+bool SpectrumFrameBus::addConsumer(Consumer* consumer)
+{
+    const juce::SpinLock::ScopedLockType lock(consumerLock);
+
+    for (auto& slot : consumers)
+    {
+        if (slot == nullptr)
+        {
+            slot = consumer;
+            return true;
+        }
+    }
+
+    jassertfalse;
+    return false;
+}
+
+void SpectrumFrameBus::removeConsumer(Consumer* consumer)
+{
+    const juce::SpinLock::ScopedLockType lock(consumerLock);
+    std::replace(consumers.begin(), consumers.end(), consumer, static_cast<Consumer*>(nullptr));
+}
+
+void SpectrumFrameBus::reserve(int maxFFTSize, int numFrames)
+{
+    numUsableFrames = juce::jlimit(1, poolSize, numFrames);
+
+    for (int i = 0; i < numUsableFrames; ++i)
+    {
+        auto& frame = *pool[static_cast<size_t>(i)];
+        frame.trackSpectrum.reserve(static_cast<size_t>(maxFFTSize));
+
+        for (auto& channelPower : frame.power)
+            channelPower.reserve(static_cast<size_t>(maxFFTSize / 2 + 1));
+    }
+}
+
+SpectrumFrame::Ptr SpectrumFrameBus::acquire(int fftSize)
+{
+    // Past numUsableFrames a frame could still need to grow
+    for (int i = 0; i < numUsableFrames; ++i)
+    {
+        auto& candidate = pool[static_cast<size_t>(i)];
+        int expected = 0;
+
+        if (! candidate->references.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+            continue;
+
+        // Ours alone now; a size change reallocates at most once per plan
+        auto& frame = *candidate;
+        frame.fftSize = fftSize;
+        frame.numBins = fftSize / 2 + 1;
+        frame.trackSpectrum.resize(static_cast<size_t>(fftSize));
+
+        for (auto& channelPower : frame.power)
+            channelPower.resize(static_cast<size_t>(frame.numBins));
+
+        return SpectrumFrame::Ptr(&frame);
+    }
+
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void SpectrumFrameBus::publish(SpectrumFrame& frame)
+{
+    frame.index = nextIndex++;
+
+    const juce::SpinLock::ScopedLockType lock(consumerLock);
+
+    for (auto* consumer : consumers)
+        if (consumer != nullptr)
+            consumer->spectrumFrameReady(frame);
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+    Analysed spectrum frames, transformed once per hop and shared by every
+    spectral view.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <complex>
+#include <utility>
+
+//==============================================================================
+// One hop's transform. The track pair is kept as the packed complex
+// transform Z = A + jB that the analysis produces (getTrackBin separates a
+// channel's bin); power is calibrated linear power of track A, track B and
+// the mean of the reference channels, size / 2 + 1 bins each.
+class SpectrumFrame
+{
+public:
+    // Shared ownership; the last one to let go hands the frame back to its pool
+    class Ptr
+    {
+    public:
+        Ptr() = default;
+        Ptr(const Ptr& other) noexcept : frame(other.frame) { retain(); }
+        Ptr(Ptr&& other) noexcept : frame(std::exchange(other.frame, nullptr)) {}
+        ~Ptr() { release(); }
+
+        Ptr& operator=(Ptr other) noexcept
+        {
+            std::swap(frame, other.frame);
+            return *this;
+        }
+
+        SpectrumFrame* get() const noexcept { return frame; }
+        SpectrumFrame* operator->() const noexcept { return frame; }
+        SpectrumFrame& operator*() const noexcept { return *frame; }
+        explicit operator bool() const noexcept { return frame != nullptr; }
+
+    private:
+        friend class SpectrumFrame;
+        friend class SpectrumFrameBus;
+        explicit Ptr(SpectrumFrame* adopted) noexcept : frame(adopted) {}
+
+        void retain() noexcept;
+        void release() noexcept;
+
+        SpectrumFrame* frame = nullptr;
+    };
+
+    // For a consumer that wants to keep the frame past its callback
+    Ptr retain() const noexcept;
+
+    // Bin k of track channel 0 (A) or 1 (B), separated from the packed transform
+    std::complex<float> getTrackBin(int channel, int k) const noexcept;
+
+    int fftSize = 0;
+    int numBins = 0;
+    double sampleRate = 0.0;
+    bool midSide = false;           // track pair is mid/side rather than left/right
+    bool hasReference = false;      // power[2] is valid
+    juce::int64 index = 0;          // counts published frames
+
+    std::vector<std::complex<float>> trackSpectrum;
+    std::array<std::vector<float>, 3> power;
+
+private:
+    friend class SpectrumFrameBus;
+    mutable std::atomic<int> references{ 0 };
+};
+
+//==============================================================================
+// A fixed pool of frames and the consumers they are published to. The
+// analysis acquires a frame, transforms into it and publishes it; every
+// consumer reads the same arrays in its callback, and the frame goes back to
+// the pool once the last reference is gone. Consumers that need a frame for
+// longer (a view that draws on the message thread, say) retain it.
+//
+// Acquiring never blocks: a free frame is claimed with one compare-exchange
+// on its reference count, and if consumers are holding every frame the hop
+// is dropped and counted. Frames grow to the FFT size on first use after a
+// plan change, so reserve() up front where that must not allocate; the bus
+// then hands out only the reserved frames.
+class SpectrumFrameBus
+{
+public:
+    static constexpr int poolSize = 24;
+    static constexpr int maxConsumers = 8;
+
+    struct Consumer
+    {
+        virtual ~Consumer() = default;
+
+        // On the analysis thread, in hop order. Keep it short.
+        virtual void spectrumFrameReady(const SpectrumFrame& frame) = 0;
+    };
+
+    SpectrumFrameBus();
+
+    // Message thread. Once removed, a consumer is guaranteed not to be
+    // called again; false if all slots are taken.
+    bool addConsumer(Consumer* consumer);
+    void removeConsumer(Consumer* consumer);
+
+    // Before analysis starts: sizes the first numFrames frames for the
+    // largest FFT and limits acquire() to them
+    void reserve(int maxFFTSize, int numFrames);
+
+    // Analysis thread. Empty when every frame is in use.
+    SpectrumFrame::Ptr acquire(int fftSize);
+    void publish(SpectrumFrame& frame);
+
+    int getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::unique_ptr<SpectrumFrame>, poolSize> pool;
+    int numUsableFrames = poolSize;
+    juce::int64 nextIndex = 0;
+    std::atomic<int> dropped{ 0 };
+
+    juce::SpinLock consumerLock;
+    std::array<Consumer*, maxConsumers> consumers{};
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumFrameBus)
+};
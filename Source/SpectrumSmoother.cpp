@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+    Fractional-octave smoothing of a power spectrum.
+  ==============================================================================
+*/
+
+#include "SpectrumSmoother.h"
+
+//==============================================================================
+void SpectrumSmoother::prepare(int bins, int octaveFraction)
+{
+    numBins = bins;
+    fraction = octaveFraction;
+
+    if (fraction <= 0)
+        return;
+
+    lowerBin.resize(static_cast<size_t>(numBins));
+    upperBin.resize(static_cast<size_t>(numBins));
+    inverseWidth.resize(static_cast<size_t>(numBins));
+    prefix.resize(static_cast<size_t>(numBins) + 1);
+
+    // Edges half the band width either side of the bin, in octaves; low
+    // bins get at least themselves
+    const double halfBand = std::pow(2.0, 0.5 / fraction);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const int lower = juce::jlimit(0, k, static_cast<int>(std::ceil(k / halfBand)));
+        const int upper = juce::jlimit(k + 1, numBins, static_cast<int>(std::floor(k * halfBand)) + 1);
+
+        lowerBin[static_cast<size_t>(k)] = lower;
+        upperBin[static_cast<size_t>(k)] = upper;
+        inverseWidth[static_cast<size_t>(k)] = 1.0f / static_cast<float>(upper - lower);
+    }
+}
+
+void SpectrumSmoother::reserve(int maxBins)
+{
+    lowerBin.reserve(static_cast<size_t>(maxBins));
+    upperBin.reserve(static_cast<size_t>(maxBins));
+    inverseWidth.reserve(static_cast<size_t>(maxBins));
+    prefix.reserve(static_cast<size_t>(maxBins) + 1);
+}
+
+void SpectrumSmoother::process(const float* power, float* destination)
+{
+    // Double precision: a quiet band after a loud one is a small difference
+    // of two large sums
+    double sum = 0.0;
+    prefix[0] = 0.0;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        sum += power[k];
+        prefix[static_cast<size_t>(k) + 1] = sum;
+    }
+
+    for (size_t k = 0; k < static_cast<size_t>(numBins); ++k)
+        destination[k] = static_cast<float>(prefix[static_cast<size_t>(upperBin[k])] - prefix[static_cast<size_t>(lowerBin[k])])
+                       * inverseWidth[k];
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+    Fractional-octave smoothing of a power spectrum.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Replaces each bin by the mean power over a band 1/N octave wide centred on
+// it, as measurement tools do. The band edges are worked out once per FFT
+// size and width, and the means come from a running sum over the bins, so a
+// pass costs two reads per bin however wide the bands get.
+class SpectrumSmoother
+{
+public:
+    // Band width as a fraction of an octave; 0 turns smoothing off
+    static constexpr std::array<int, 6> fractions{ 0, 1, 3, 6, 12, 24 };
+
+    // Worker thread, when the bin count or width changes (allocates, unless
+    // reserve() was called for at least this many bins). Inline, the message
+    // thread prepares a new one and hands it over.
+    void prepare(int numBins, int octaveFraction);
+    void reserve(int maxBins);
+
+    bool isPreparedFor(int bins, int octaveFraction) const { return numBins == bins && fraction == octaveFraction; }
+    int getNumBins() const { return numBins; }
+    bool isActive() const { return fraction > 0; }
+
+    // destination may not alias power
+    void process(const float* power, float* destination);
+
+private:
+    int numBins = 0;
+    int fraction = 0;
+
+    // Band of bin k is [lowerBin[k], upperBin[k]); prefix[k] is the sum of bins below k
+    std::vector<int> lowerBin, upperBin;
+    std::vector<float> inverseWidth;
+    std::vector<double> prefix;
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+    Tonal-balance target curves for the long-term average spectrum.
+  ==============================================================================
+*/
+
+#include "SpectrumTargets.h"
+#include "SpectrumEngine.h"
+
+namespace
+{
+    constexpr int numPoints = 10;
+    constexpr std::array<float, numPoints> pointFrequencies{ 31.5f, 63.0f, 125.0f, 250.0f, 500.0f,
+                                                             1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f };
+    constexpr std::array<float, numPoints> pointTolerances{ 6.0f, 5.0f, 4.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 4.0f, 6.0f };
+
+    // dB re 1 kHz, indexed by Genre (none is flat and never drawn)
+    constexpr std::array<std::array<float, numPoints>, SpectrumTargets::numGenres> pointLevels{ {
+        { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+        { 14.0f, 15.0f, 12.0f, 7.0f, 3.0f, 0.0f, -4.0f, -8.0f, -13.0f, -21.0f },
+        { 10.0f, 13.0f, 11.0f, 7.0f, 3.0f, 0.0f, -3.0f, -7.0f, -12.0f, -20.0f },
+        { 20.0f, 20.0f, 14.0f, 8.0f, 3.0f, 0.0f, -4.0f, -9.0f, -14.0f, -22.0f },
+        { 6.0f, 10.0f, 10.0f, 7.0f, 3.0f, 0.0f, -5.0f, -10.0f, -16.0f, -25.0f },
+        { 4.0f, 9.0f, 10.0f, 8.0f, 4.0f, 0.0f, -6.0f, -12.0f, -19.0f, -28.0f },
+    } };
+
+    // Linear in log frequency between points, flat beyond the ends
+    float interpolate(const std::array<float, numPoints>& values, float frequency)
+    {
+        if (frequency <= pointFrequencies.front())
+            return values.front();
+
+        for (size_t i = 1; i < pointFrequencies.size(); ++i)
+        {
+            if (frequency <= pointFrequencies[i])
+            {
+                const float position = std::log(frequency / pointFrequencies[i - 1])
+                                     / std::log(pointFrequencies[i] / pointFrequencies[i - 1]);
+                return values[i - 1] + position * (values[i] - values[i - 1]);
+            }
+        }
+
+        return values.back();
+    }
+}
+
+//==============================================================================
+juce::String SpectrumTargets::getName(Genre genre)
+{
+    switch (genre)
+    {
+        case Genre::pop:          return "Pop";
+        case Genre::rock:         return "Rock";
+        case Genre::hipHopEDM:    return "Hip-hop / EDM";
+        case Genre::acousticJazz: return "Acoustic / Jazz";
+        case Genre::classical:    return "Classical";
+        case Genre::none:
+        default:                  return "No target";
+    }
+}
+
+void SpectrumTargets::fillColumns(Genre genre, float* centre, float* tolerance, int numColumns)
+{
+    const auto& levels = pointLevels[static_cast<size_t>(genre)];
+    const float logSpan = std::log(SpectrumPlan::maxDisplayFrequency / SpectrumPlan::minDisplayFrequency);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const float position = static_cast<float>(column) / static_cast<float>(juce::jmax(1, numColumns - 1));
+        const float frequency = SpectrumPlan::minDisplayFrequency * std::exp(position * logSpan);
+
+        centre[column] = interpolate(levels, frequency);
+        tolerance[column] = interpolate(pointTolerances, frequency);
+    }
+}
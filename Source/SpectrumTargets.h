@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+    Tonal-balance target curves for the long-term average spectrum.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+// Typical long-term spectra of finished mixes per genre, as one level per
+// display column relative to 1 kHz with a tolerance either side. They are
+// broad guides, not standards: a mix well inside the band has a
+// conventional tonal balance.
+struct SpectrumTargets
+{
+    enum class Genre { none = 0, pop, rock, hipHopEDM, acousticJazz, classical };
+    static constexpr int numGenres = 6;
+
+    static juce::String getName(Genre genre);
+
+    // Centre and half-width (dB) of the band at each display column, on the
+    // same log-frequency axis as SpectrumEngine's columns
+    static void fillColumns(Genre genre, float* centre, float* tolerance, int numColumns);
+};
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+    Opt-in Chrome trace (chrome://tracing, Perfetto) timeline recorder.
+  ==============================================================================
+*/
+
+#include "TraceRecorder.h"
+
+namespace
+{
+    // Buffers are never freed once handed out, so this can't dangle
+    thread_local void* currentThreadBuffer = nullptr;
+
+    // Nor given back, so a thread that found none needn't look again
+    thread_local bool noBufferLeft = false;
+}
+
+//==============================================================================
+TraceRecorder& TraceRecorder::getInstance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : juce::Thread("TrackTweak Trace")
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+    delete bufferPool.load();
+}
+
+void TraceRecorder::addUser()
+{
+    if (numUsers.fetch_add(1) > 0)
+        return;
+
+    const auto path = juce::SystemStats::getEnvironmentVariable("TRACKTWEAK_TRACE_FILE", {});
+
+    if (path.isNotEmpty() && juce::File::isAbsolutePath(path))
+        start(juce::File(path));
+}
+
+void TraceRecorder::removeUser()
+{
+    if (numUsers.fetch_sub(1) == 1)
+        stop();
+}
+
+//==============================================================================
+void TraceRecorder::record(const char* name, juce::int64 start, juce::int64 end) noexcept
+{
+    auto* buffer = static_cast<ThreadBuffer*>(currentThreadBuffer);
+
+    if (buffer == nullptr)
+    {
+        buffer = noBufferLeft ? nullptr : claimBuffer();
+
+        if (buffer == nullptr)
+        {
+            droppedWithoutBuffer.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        currentThreadBuffer = buffer;
+        buffer->firstName.store(name, std::memory_order_release);
+    }
+
+    const auto write = buffer->writeIndex.load(std::memory_order_relaxed);
+
+    if (write - buffer->readIndex.load(std::memory_order_acquire) >= ThreadBuffer::capacity)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[write % ThreadBuffer::capacity] = { name, start, end };
+    buffer->writeIndex.store(write + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::claimBuffer() noexcept
+{
+    auto* pool = bufferPool.load(std::memory_order_acquire);
+    if (pool == nullptr)
+        return nullptr;
+
+    for (auto& buffer : *pool)
+    {
+        bool expected = false;
+        if (buffer.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            return &buffer;
+    }
+
+    // Raise maxThreads if this shows up in a trace
+    noBufferLeft = true;
+    return nullptr;
+}
+
+//==============================================================================
+void TraceRecorder::start(const juce::File& file)
+{
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (! stream->openedOk())
+        return;
+
+    stream->setPosition(0);
+    stream->truncate();
+    stream->writeText("{\"traceEvents\":[\n", false, false, nullptr);
+
+    // Allocated once; threads keep the buffer they claimed for later sessions
+    if (bufferPool.load() == nullptr)
+        bufferPool.store(new BufferPool());
+
+    output = std::move(stream);
+    originTicks = juce::Time::getHighResolutionTicks();
+    microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    firstEvent = true;
+    droppedWithoutBuffer.store(0);
+
+    recording.store(true);
+    startThread(juce::Thread::Priority::low);
+}
+
+void TraceRecorder::stop()
+{
+    if (! recording.exchange(false))
+        return;
+
+    stopThread(2000);
+    drain();
+
+    // Name each thread's track after the first scope it recorded
+
+    for (int i = 0; i < maxThreads; ++i)
+    {
+        auto& buffer = (*bufferPool.load())[static_cast<size_t>(i)];
+        const char* firstName = buffer.firstName.load(std::memory_order_acquire);
+
+        if (firstName == nullptr)
+            continue;
+
+        writeEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String(i)
+                   + ",\"args\":{\"name\":\"" + juce::String(firstName) + " thread (dropped "
+                   + juce::String(buffer.dropped.load()) + ")\"}}");
+    }
+
+    if (const auto dropped = droppedWithoutBuffer.load(); dropped > 0)
+        writeEvent("{\"name\":\"process_labels\",\"ph\":\"M\",\"pid\":1,\"args\":{\"labels\":\""
+                   + juce::String(dropped) + " events dropped from threads beyond the "
+                   + juce::String(maxThreads) + " buffers\"}}");
+
+    output->writeText("\n]}\n", false, false, nullptr);
+    output = nullptr;
+}
+
+void TraceRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait(50);
+    }
+}
+
+void TraceRecorder::drain()
+{
+    for (int i = 0; i < maxThreads; ++i)
+    {
+        auto& buffer = (*bufferPool.load())[static_cast<size_t>(i)];
+        auto read = buffer.readIndex.load(std::memory_order_relaxed);
+        const auto write = buffer.writeIndex.load(std::memory_order_acquire);
+
+        for (; read != write; ++read)
+        {
+            const auto& event = buffer.events[read % ThreadBuffer::capacity];
+
+            // Left over from an earlier session
+            if (event.start < originTicks)
+                continue;
+
+            const double start = static_cast<double>(event.start - originTicks) * microsecondsPerTick;
+            const double duration = static_cast<double>(event.end - event.start) * microsecondsPerTick;
+
+            writeEvent("{\"name\":\"" + juce::String(event.name) + "\",\"ph\":\"X\",\"ts\":" + juce::String(start, 3)
+                       + ",\"dur\":" + juce::String(duration, 3) + ",\"pid\":1,\"tid\":" + juce::String(i) + "}");
+        }
+
+        buffer.readIndex.store(read, std::memory_order_release);
+    }
+
+    output->flush();
+}
+
+void TraceRecorder::writeEvent(const juce::String& json)
+{
+    output->writeText(firstEvent ? json : ",\n" + json, false, false, nullptr);
+    firstEvent = false;
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+    Opt-in Chrome trace (chrome://tracing, Perfetto) timeline recorder.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Build with TRACKTWEAK_TRACING=1 to compile the trace points in. Then set
+// TRACKTWEAK_TRACE_FILE to an output path before the host loads the plugin;
+// the file is finished when the last instance goes away.
+#ifndef TRACKTWEAK_TRACING
+ #define TRACKTWEAK_TRACING 0
+#endif
+
+#if TRACKTWEAK_TRACING
+ #define TRACKTWEAK_TRACE_SCOPE(name) const TraceRecorder::Scope JUCE_JOIN_MACRO(traceScope, __LINE__)(name)
+ #define TRACKTWEAK_TRACE_ACCUMULATE(totalTicks) const TraceRecorder::AccumulatingScope JUCE_JOIN_MACRO(traceScope, __LINE__)(totalTicks)
+#else
+ #define TRACKTWEAK_TRACE_SCOPE(name)
+ #define TRACKTWEAK_TRACE_ACCUMULATE(totalTicks)
+#endif
+
+//==============================================================================
+// Each thread that records claims a ring from a pool allocated when tracing
+// starts, so recording never allocates or locks: a scope is two tick reads
+// and one slot write. A background thread drains the rings into the file.
+// Events from threads beyond the pool are dropped, but counted, and the
+// count is written into the file.
+class TraceRecorder : private juce::Thread
+{
+public:
+    static TraceRecorder& getInstance();
+
+    // One call per plugin instance. The first user starts recording if
+    // TRACKTWEAK_TRACE_FILE is set; the last one finishes the file.
+    void addUser();
+    void removeUser();
+
+    bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+
+    // A span from startTicks (juce::Time::getHighResolutionTicks) to now, for
+    // intervals that don't fit in one scope. Same rule for the name.
+    void recordSince(const char* name, juce::int64 startTicks) noexcept
+    {
+        if (isRecording())
+            record(name, startTicks, juce::Time::getHighResolutionTicks());
+    }
+
+    // A stage that runs in many short pieces within one call (once per
+    // sub-block, say): the pieces are summed with AccumulatingScope and
+    // recorded as one span of that length, ending at endTicks
+    void recordTotal(const char* name, juce::int64 totalTicks, juce::int64 endTicks) noexcept
+    {
+        if (isRecording() && totalTicks > 0)
+            record(name, endTicks - totalTicks, endTicks);
+    }
+
+    // Scope names must be string literals (only the pointer is stored)
+    class Scope
+    {
+    public:
+        explicit Scope(const char* scopeName) noexcept
+            : name(scopeName),
+              start(getInstance().isRecording() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (start != 0)
+                getInstance().record(name, start, juce::Time::getHighResolutionTicks());
+        }
+
+    private:
+        const char* name;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    class AccumulatingScope
+    {
+    public:
+        explicit AccumulatingScope(juce::int64& totalTicks) noexcept
+            : total(totalTicks),
+              start(getInstance().isRecording() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~AccumulatingScope()
+        {
+            if (start != 0)
+                total += juce::Time::getHighResolutionTicks() - start;
+        }
+
+    private:
+        juce::int64& total;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(AccumulatingScope)
+    };
+
+private:
+    struct Event
+    {
+        const char* name;
+        juce::int64 start, end;
+    };
+
+    // Single producer (the owning thread), single consumer (the flusher)
+    struct ThreadBuffer
+    {
+        static constexpr int capacity = 8192;
+
+        std::atomic<bool> claimed{ false };
+        std::atomic<juce::uint32> writeIndex{ 0 }, readIndex{ 0 };
+        std::atomic<juce::uint32> dropped{ 0 };
+        std::atomic<const char*> firstName{ nullptr };
+        std::array<Event, capacity> events;
+    };
+
+    static constexpr int maxThreads = 16;
+    using BufferPool = std::array<ThreadBuffer, maxThreads>;
+
+    TraceRecorder();
+    ~TraceRecorder() override;
+
+    void record(const char* name, juce::int64 start, juce::int64 end) noexcept;
+    ThreadBuffer* claimBuffer() noexcept;
+
+    void start(const juce::File& file);
+    void stop();
+    void run() override;
+    void drain();
+    void writeEvent(const juce::String& json);
+
+    std::atomic<bool> recording{ false };
+    std::atomic<BufferPool*> bufferPool{ nullptr };
+    std::atomic<juce::uint32> droppedWithoutBuffer{ 0 };
+
+    // Hosts may create instances on more than one thread
+    std::atomic<int> numUsers{ 0 };
+
+    // Flusher thread
+    std::unique_ptr<juce::FileOutputStream> output;
+    juce::int64 originTicks = 0;
+    double microsecondsPerTick = 0.0;
+    bool firstEvent = true;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+    Micro-benchmarks for the DSP hot paths. Not part of ctest: run the
+    Release build on a quiet machine and compare numbers from the same run.
+
+    cmake -S Tests -B build && cmake --build build && build/tracktweak_benchmarks
+  ==============================================================================
+*/
+
+#include "DecibelConversion.h"
+#include "LoudnessMeter.h"
+#include "SpectrumFrameBus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <type_traits>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numChannels = 2;
+    constexpr int numRuns = 11;
+
+    // Keeps results alive so the optimiser can't drop the work
+    volatile float sink = 0.0f;
+
+    // Best of numRuns, in nanoseconds per item
+    template <typename Function>
+    double timePerItem(long long numItems, Function&& function)
+    {
+        double best = 1.0e30;
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed / static_cast<double>(numItems));
+        }
+
+        return best;
+    }
+
+    template <typename SampleType>
+    std::vector<std::vector<SampleType>> createNoise(int numSamples)
+    {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+        std::vector<std::vector<SampleType>> channels(numChannels, std::vector<SampleType>(static_cast<size_t>(numSamples)));
+
+        for (auto& channel : channels)
+            for (auto& sample : channel)
+                sample = static_cast<SampleType>(distribution(random));
+
+        return channels;
+    }
+
+    // Feeds the meter in host-sized blocks, converting to SampleType first
+    // when the input is in another precision
+    template <typename SampleType, typename InputType>
+    void runLoudnessMeter(LoudnessMeter& meter, const std::vector<std::vector<InputType>>& input)
+    {
+        const int numSamples = static_cast<int>(input[0].size());
+        std::vector<std::vector<SampleType>> converted(numChannels, std::vector<SampleType>(blockSize));
+        std::array<const SampleType*, numChannels> channels;
+
+        for (int start = 0; start + blockSize <= numSamples; start += blockSize)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                if constexpr (std::is_same_v<SampleType, InputType>)
+                {
+                    channels[channel] = input[channel].data() + start;
+                }
+                else
+                {
+                    std::copy_n(input[channel].data() + start, blockSize, converted[channel].data());
+                    channels[channel] = converted[channel].data();
+                }
+            }
+
+            meter.process(channels.data(), numChannels, blockSize);
+        }
+
+        sink = meter.getMomentaryLUFS();
+    }
+
+    //==============================================================================
+    // The loudness meter is the per-sample cost that runs in the host's
+    // precision. A host that hands over doubles is measured three ways:
+    // the native double path, the float path, and the conversion copy to
+    // float a plugin without double support would make first.
+    void benchmarkSamplePrecision()
+    {
+        constexpr int numSamples = static_cast<int>(sampleRate) * 10;
+        const auto floatInput = createNoise<float>(numSamples);
+        const auto doubleInput = createNoise<double>(numSamples);
+        const long long numItems = static_cast<long long>(numSamples) * numChannels;
+
+        LoudnessMeter meter;
+        meter.prepare(sampleRate);
+
+        const double floatTime = timePerItem(numItems, [&] { runLoudnessMeter<float>(meter, floatInput); });
+        const double doubleTime = timePerItem(numItems, [&] { runLoudnessMeter<double>(meter, doubleInput); });
+        const double convertedTime = timePerItem(numItems, [&] { runLoudnessMeter<float>(meter, doubleInput); });
+
+        std::printf("LoudnessMeter, %d-sample blocks at %.0f Hz (ns per sample)\n", blockSize, sampleRate);
+        std::printf("  float input, float path        %7.2f\n", floatTime);
+        std::printf("  double input, double path      %7.2f\n", doubleTime);
+        std::printf("  double input, copied to float  %7.2f\n\n", convertedTime);
+    }
+
+    //==============================================================================
+    // The array kernel, the single-value version and the std::log10 loop it
+    // replaced, over a spectrum-sized array of powers spread across the
+    // display range, with the largest error against double precision
+    void benchmarkDecibelConversion()
+    {
+        constexpr int numValues = 4096;
+        constexpr int numPasses = 2000;
+        constexpr float floorDecibels = -120.0f;
+
+        std::mt19937 random(2);
+        std::uniform_real_distribution<float> exponent(-13.0f, 1.0f);
+        std::vector<float> power(numValues), decibels(numValues);
+
+        for (auto& value : power)
+            value = std::pow(10.0f, exponent(random));
+
+        power[0] = 0.0f;
+        const long long numItems = static_cast<long long>(numValues) * numPasses;
+
+        auto maxError = [&]
+        {
+            double error = 0.0;
+
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                const double exact = std::max(static_cast<double>(floorDecibels), 10.0 * std::log10(static_cast<double>(power[i])));
+                error = std::max(error, std::abs(decibels[i] - exact));
+            }
+
+            return error;
+        };
+
+        const double kernelTime = timePerItem(numItems, [&]
+        {
+            for (int pass = 0; pass < numPasses; ++pass)
+                DecibelConversion::powerToDecibels(decibels.data(), power.data(), numValues, floorDecibels);
+
+            sink = decibels[numValues / 2];
+        });
+
+        const double kernelError = maxError();
+
+        const double scalarTime = timePerItem(numItems, [&]
+        {
+            for (int pass = 0; pass < numPasses; ++pass)
+                for (int i = 0; i < numValues; ++i)
+                    decibels[static_cast<size_t>(i)] = DecibelConversion::powerToDecibels(power[static_cast<size_t>(i)], floorDecibels);
+
+            sink = decibels[numValues / 2];
+        });
+
+        const double scalarError = maxError();
+
+        const double log10Time = timePerItem(numItems, [&]
+        {
+            const float minimum = std::pow(10.0f, floorDecibels / 10.0f);
+
+            for (int pass = 0; pass < numPasses; ++pass)
+                for (int i = 0; i < numValues; ++i)
+                    decibels[static_cast<size_t>(i)] = 10.0f * std::log10(std::max(power[static_cast<size_t>(i)], minimum));
+
+            sink = decibels[numValues / 2];
+        });
+
+        std::printf("Power to dB, %d values (ns per value, max error in dB)\n", numValues);
+        std::printf("  DecibelConversion, array       %7.2f  %.6f\n", kernelTime, kernelError);
+        std::printf("  DecibelConversion, per value   %7.2f  %.6f\n", scalarTime, scalarError);
+        std::printf("  std::log10                     %7.2f\n\n", log10Time);
+    }
+
+    //==============================================================================
+    // In-place radix-2 transform, standing in for the plugin's FFT
+    void transform(std::complex<float>* data, int size)
+    {
+        for (int i = 1, j = 0; i < size; ++i)
+        {
+            int bit = size >> 1;
+
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+
+            j ^= bit;
+
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+
+        for (int length = 2; length <= size; length <<= 1)
+        {
+            const auto step = std::polar(1.0f, -juce::MathConstants<float>::twoPi / static_cast<float>(length));
+
+            for (int start = 0; start < size; start += length)
+            {
+                std::complex<float> twiddle(1.0f);
+
+                for (int k = 0; k < length / 2; ++k, twiddle *= step)
+                {
+                    const auto odd = twiddle * data[start + k + length / 2];
+                    data[start + k + length / 2] = data[start + k] - odd;
+                    data[start + k] += odd;
+                }
+            }
+        }
+    }
+
+    // Transforms the packed track pair of one hop and separates the power
+    // of track A, as the analysis does for every frame it publishes
+    void analyseHop(SpectrumFrame& frame, const std::vector<std::complex<float>>& input)
+    {
+        std::copy(input.begin(), input.end(), frame.trackSpectrum.begin());
+        transform(frame.trackSpectrum.data(), frame.fftSize);
+
+        for (int k = 0; k < frame.numBins; ++k)
+            frame.power[0][static_cast<size_t>(k)] = std::norm(frame.getTrackBin(0, k));
+    }
+
+    // A view's per-frame work: an exponential average of the power
+    struct AveragingView : SpectrumFrameBus::Consumer
+    {
+        explicit AveragingView(int numBins) : average(static_cast<size_t>(numBins)) {}
+
+        void spectrumFrameReady(const SpectrumFrame& frame) override
+        {
+            for (size_t k = 0; k < average.size(); ++k)
+                average[k] += 0.2f * (frame.power[0][k] - average[k]);
+        }
+
+        std::vector<float> average;
+    };
+
+    // Cost per hop as views are added: with the bus the hop is transformed
+    // once and each view only averages, against each view transforming the
+    // hop for itself
+    void benchmarkFrameBus()
+    {
+        constexpr int fftSize = 8192;
+        constexpr int numBins = fftSize / 2 + 1;
+        constexpr int numHops = 200;
+
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+        std::vector<std::complex<float>> input(fftSize);
+
+        for (auto& sample : input)
+            sample = { distribution(random), distribution(random) };
+
+        std::printf("Spectrum frames, FFT size %d (us per hop, shared transform and one per view)\n", fftSize);
+
+        for (const int numViews : { 1, 2, 4, SpectrumFrameBus::maxConsumers })
+        {
+            SpectrumFrameBus bus;
+            bus.reserve(fftSize, 1);
+            std::vector<AveragingView> views(static_cast<size_t>(numViews), AveragingView(numBins));
+
+            for (auto& view : views)
+                bus.addConsumer(&view);
+
+            const double sharedTime = timePerItem(numHops, [&]
+            {
+                for (int hop = 0; hop < numHops; ++hop)
+                {
+                    auto frame = bus.acquire(fftSize);
+                    analyseHop(*frame, input);
+                    bus.publish(*frame);
+                }
+            });
+
+            for (auto& view : views)
+                bus.removeConsumer(&view);
+
+            const double separateTime = timePerItem(numHops, [&]
+            {
+                for (int hop = 0; hop < numHops; ++hop)
+                {
+                    for (auto& view : views)
+                    {
+                        auto frame = bus.acquire(fftSize);
+                        analyseHop(*frame, input);
+                        view.spectrumFrameReady(*frame);
+                    }
+                }
+            });
+
+            sink = views[0].average[1];
+            std::printf("  %d view%s  %9.1f  %9.1f\n", numViews, numViews == 1 ? " " : "s",
+                        sharedTime / 1000.0, separateTime / 1000.0);
+        }
+
+        std::printf("\n");
+    }
+}
+
+//==============================================================================
+int main()
+{
+    benchmarkSamplePrecision();
+    benchmarkDecibelConversion();
+    benchmarkFrameBus();
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+    Editor open times: from the host asking for the editor until its first
+    frame has been painted, and until every view has been built (the
+    editor builds them over several timer ticks after that first paint).
+    Built against the real framework, so
+    only when TRACKTWEAK_JUCE_DIR is set (see CMakeLists.txt). On Linux it
+    needs a display; xvfb-run will do.
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr int numReopens = 20;
+
+    using EditorPtr = std::unique_ptr<juce::AudioProcessorEditor>;
+
+    // Creates the editor and paints it into an image, as the host's first
+    // frame would; milliseconds for both
+    double openAndPaint(TrackTweakAudioProcessor& processor, EditorPtr& editor)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        editor.reset(processor.createEditor());
+        const auto frame = editor->createComponentSnapshot(editor->getLocalBounds(), true, 1.0f);
+
+        const auto end = juce::Time::getHighResolutionTicks();
+        juce::ignoreUnused(frame);
+        return 1000.0 * juce::Time::highResolutionTicksToSeconds(end - start);
+    }
+
+    // Runs the message loop until the editor's timer has built every view,
+    // as it would in a host, then closes the editor, which leaves its last
+    // frame in the shared cache. Returns the editor's own ready time.
+    double settleAndClose(EditorPtr& editor)
+    {
+        auto& trackTweakEditor = dynamic_cast<TrackTweakAudioProcessorEditor&>(*editor);
+
+        for (int i = 0; i < 200 && trackTweakEditor.getReadyMilliseconds() < 0.0f; ++i)
+            juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+
+        const double ready = trackTweakEditor.getReadyMilliseconds();
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(100);
+        editor = nullptr;
+        return ready;
+    }
+
+    struct Times
+    {
+        std::vector<double> firstPaint, ready;
+    };
+
+    void printTimes(const char* label, Times times)
+    {
+        auto print = [label](const char* what, std::vector<double>& values)
+        {
+            std::sort(values.begin(), values.end());
+            std::printf("  %-34s %-12s %7.2f  %7.2f\n", label, what, values[values.size() / 2], values.back());
+        };
+
+        print("first paint", times.firstPaint);
+        print("ready", times.ready);
+    }
+
+    Times openAndClose(TrackTweakAudioProcessor& processor, EditorPtr& editor, int numTimes)
+    {
+        Times times;
+
+        for (int i = 0; i < numTimes; ++i)
+        {
+            times.firstPaint.push_back(openAndPaint(processor, editor));
+            times.ready.push_back(settleAndClose(editor));
+        }
+
+        return times;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    TrackTweakAudioProcessor first, second;
+    first.prepareToPlay(48000.0, 512);
+    second.prepareToPlay(48000.0, 512);
+
+    EditorPtr editor;
+    std::printf("Editor open times (ms, median and worst)\n");
+
+    // Nothing shared has been built yet
+    printTimes("first editor in the process", openAndClose(first, editor, 1));
+
+    // Shared assets exist, but this instance has no cached frame
+    printTimes("another instance's first editor", openAndClose(second, editor, 1));
+
+    printTimes("reopened, from the cached frame", openAndClose(first, editor, numReopens));
+
+    first.releaseResources();
+    second.releaseResources();
+    return 0;
+}
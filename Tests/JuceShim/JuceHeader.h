@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+    Just enough of JUCE for the DSP sources to build in the command-line
+    tests and benchmarks without the framework. Behaviour matches the JUCE
+    classes for the parts the meters and the frame bus use; nothing else is
+    provided.
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define jassert(expression)         assert(expression)
+#define jassertfalse                assert(false)
+
+#define JUCE_DECLARE_NON_COPYABLE(className) \
+    className(const className&) = delete;    \
+    className& operator=(const className&) = delete;
+
+#define JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(className) \
+    JUCE_DECLARE_NON_COPYABLE(className)
+
+namespace juce
+{
+    using int64 = std::int64_t;
+    using uint64 = std::uint64_t;
+    using int32 = std::int32_t;
+    using uint32 = std::uint32_t;
+    using uint8 = std::uint8_t;
+
+    template <typename Type> constexpr Type jmax(Type a, Type b) { return a < b ? b : a; }
+    template <typename Type> constexpr Type jmin(Type a, Type b) { return b < a ? b : a; }
+
+    template <typename Type>
+    constexpr Type jlimit(Type lowerLimit, Type upperLimit, Type value)
+    {
+        return value < lowerLimit ? lowerLimit : (upperLimit < value ? upperLimit : value);
+    }
+
+    template <typename Type>
+    constexpr bool isPositiveAndBelow(Type value, Type upperLimit)
+    {
+        return Type() <= value && value < upperLimit;
+    }
+
+    template <typename FloatType>
+    int roundToInt(FloatType value) { return static_cast<int>(std::lround(value)); }
+
+    template <typename FloatType>
+    struct MathConstants
+    {
+        static constexpr FloatType pi = static_cast<FloatType>(3.141592653589793238L);
+        static constexpr FloatType twoPi = static_cast<FloatType>(2 * 3.141592653589793238L);
+        static constexpr FloatType halfPi = static_cast<FloatType>(3.141592653589793238L / 2);
+        static constexpr FloatType sqrt2 = static_cast<FloatType>(1.4142135623730950488L);
+    };
+
+    //==============================================================================
+    // Lock-free single-reader, single-writer index bookkeeping, as juce::AbstractFifo
+    class AbstractFifo
+    {
+    public:
+        explicit AbstractFifo(int capacity) : bufferSize(capacity) { jassert(capacity > 0); }
+
+        int getTotalSize() const noexcept { return bufferSize; }
+        int getFreeSpace() const noexcept { return bufferSize - getNumReady() - 1; }
+
+        int getNumReady() const noexcept
+        {
+            const int start = validStart.load(), end = validEnd.load();
+            return end >= start ? end - start : bufferSize - (start - end);
+        }
+
+        void reset() noexcept
+        {
+            validEnd = 0;
+            validStart = 0;
+        }
+
+        struct ScopedRead;
+        struct ScopedWrite;
+
+        ScopedRead read(int numToRead) noexcept;
+        ScopedWrite write(int numToWrite) noexcept;
+
+        void prepareToWrite(int numToWrite, int& startIndex1, int& blockSize1, int& startIndex2, int& blockSize2) const noexcept
+        {
+            const int start = validStart.load(), end = validEnd.load();
+            const int freeSpace = end >= start ? bufferSize - (end - start) : start - end;
+            numToWrite = jmin(numToWrite, freeSpace - 1);
+
+            if (numToWrite <= 0)
+            {
+                startIndex1 = blockSize1 = startIndex2 = blockSize2 = 0;
+                return;
+            }
+
+            startIndex1 = end;
+            startIndex2 = 0;
+            blockSize1 = jmin(bufferSize - end, numToWrite);
+            blockSize2 = jmax(0, jmin(numToWrite - blockSize1, start));
+        }
+
+        void finishedWrite(int numWritten) noexcept
+        {
+            int newEnd = validEnd.load() + numWritten;
+            if (newEnd >= bufferSize)
+                newEnd -= bufferSize;
+
+            validEnd = newEnd;
+        }
+
+        void prepareToRead(int numWanted, int& startIndex1, int& blockSize1, int& startIndex2, int& blockSize2) const noexcept
+        {
+            const int start = validStart.load(), end = validEnd.load();
+            const int numReady = end >= start ? end - start : bufferSize - (start - end);
+            numWanted = jmin(numWanted, numReady);
+
+            if (numWanted <= 0)
+            {
+                startIndex1 = blockSize1 = startIndex2 = blockSize2 = 0;
+                return;
+            }
+
+            startIndex1 = start;
+            startIndex2 = 0;
+            blockSize1 = jmin(bufferSize - start, numWanted);
+            blockSize2 = jmax(0, numWanted - blockSize1);
+        }
+
+        void finishedRead(int numRead) noexcept
+        {
+            int newStart = validStart.load() + numRead;
+            if (newStart >= bufferSize)
+                newStart -= bufferSize;
+
+            validStart = newStart;
+        }
+
+    private:
+        const int bufferSize;
+        std::atomic<int> validStart{ 0 }, validEnd{ 0 };
+    };
+
+    struct AbstractFifo::ScopedRead
+    {
+        ScopedRead(AbstractFifo& f, int num) : fifo(f) { fifo.prepareToRead(num, startIndex1, blockSize1, startIndex2, blockSize2); }
+        ~ScopedRead() { fifo.finishedRead(blockSize1 + blockSize2); }
+
+        AbstractFifo& fifo;
+        int startIndex1, blockSize1, startIndex2, blockSize2;
+    };
+
+    struct AbstractFifo::ScopedWrite
+    {
+        ScopedWrite(AbstractFifo& f, int num) : fifo(f) { fifo.prepareToWrite(num, startIndex1, blockSize1, startIndex2, blockSize2); }
+        ~ScopedWrite() { fifo.finishedWrite(blockSize1 + blockSize2); }
+
+        AbstractFifo& fifo;
+        int startIndex1, blockSize1, startIndex2, blockSize2;
+    };
+
+    inline AbstractFifo::ScopedRead AbstractFifo::read(int numToRead) noexcept { return { *this, numToRead }; }
+    inline AbstractFifo::ScopedWrite AbstractFifo::write(int numToWrite) noexcept { return { *this, numToWrite }; }
+
+    //==============================================================================
+    // A busy-waiting lock, as juce::SpinLock
+    class SpinLock
+    {
+    public:
+        void enter() const noexcept
+        {
+            while (! tryEnter())
+                std::this_thread::yield();
+        }
+
+        bool tryEnter() const noexcept { return ! locked.exchange(true, std::memory_order_acquire); }
+        void exit() const noexcept { locked.store(false, std::memory_order_release); }
+
+        struct ScopedLockType
+        {
+            explicit ScopedLockType(const SpinLock& l) noexcept : lock(l) { lock.enter(); }
+            ~ScopedLockType() { lock.exit(); }
+
+            const SpinLock& lock;
+        };
+
+    private:
+        mutable std::atomic<bool> locked{ false };
+    };
+}
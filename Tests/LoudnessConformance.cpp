@@ -0,0 +1,389 @@
+/*
+  ==============================================================================
+    LoudnessMeter conformance: the EBU Tech 3341 (loudness, true peak) and
+    Tech 3342 (loudness range) synthetic test signals, plus the ITU-R
+    BS.2217 gating checks, at 44.1 / 48 / 96 / 192 kHz and several host
+    block sizes. Tolerances are the ones the specs give.
+
+    cmake -S Tests -B build && cmake --build build && ctest --test-dir build
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace
+{
+    constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+    // Powers of two, a broadcast-style odd size and one larger than a 100 ms block
+    constexpr int blockSizes[] = { 64, 441, 512, 1000, 8192 };
+
+    int numChecks = 0, numFailures = 0;
+
+    void check(bool passed, const std::string& context, const char* what, double value, double expected,
+               double below, double above)
+    {
+        ++numChecks;
+
+        if (passed)
+            return;
+
+        ++numFailures;
+        std::printf("FAIL %s: %s = %.3f, expected %.3f (-%.2f / +%.2f)\n",
+                    context.c_str(), what, value, expected, below, above);
+    }
+
+    void expectNear(const std::string& context, const char* what, double value, double expected, double below, double above)
+    {
+        check(value >= expected - below && value <= expected + above, context, what, value, expected, below, above);
+    }
+
+    void expectNear(const std::string& context, const char* what, double value, double expected, double tolerance)
+    {
+        expectNear(context, what, value, expected, tolerance, tolerance);
+    }
+
+    //==============================================================================
+    // A stereo sine, the same on both channels, as a list of level segments
+    struct Segment
+    {
+        double seconds;
+        double peakdBFS;
+    };
+
+    struct Signal
+    {
+        std::vector<Segment> segments;
+        double frequency = 1000.0;
+        double phaseDegrees = 0.0;
+        double fadeInSeconds = 0.0;    // raised-cosine fade at the start
+    };
+
+    // Feeds the signal through the meter in host-sized blocks, calling
+    // 'observe' after each one with the seconds of audio processed so far
+    void run(LoudnessMeter& meter, const Signal& signal, double sampleRate, int blockSize,
+             const std::function<void(double)>& observe = {})
+    {
+        std::vector<float> left(static_cast<size_t>(blockSize)), right(static_cast<size_t>(blockSize));
+        const float* channels[] = { left.data(), right.data() };
+
+        const double phaseStep = juce::MathConstants<double>::twoPi * signal.frequency / sampleRate;
+        const double startPhase = signal.phaseDegrees * juce::MathConstants<double>::pi / 180.0;
+        const auto fadeLength = static_cast<juce::int64>(std::llround(signal.fadeInSeconds * sampleRate));
+        juce::int64 position = 0;
+
+        for (const auto& segment : signal.segments)
+        {
+            const double amplitude = std::pow(10.0, segment.peakdBFS / 20.0);
+            const auto end = position + static_cast<juce::int64>(std::llround(segment.seconds * sampleRate));
+
+            while (position < end)
+            {
+                const int count = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), end - position));
+
+                for (int i = 0; i < count; ++i)
+                {
+                    // Phase from the sample index, so long signals don't drift
+                    const double phase = startPhase + phaseStep * static_cast<double>(position + i);
+                    double gain = amplitude;
+
+                    if (position + i < fadeLength)
+                        gain *= 0.5 - 0.5 * std::cos(juce::MathConstants<double>::pi * static_cast<double>(position + i)
+                                                         / static_cast<double>(fadeLength));
+
+                    left[static_cast<size_t>(i)] = right[static_cast<size_t>(i)] = static_cast<float>(gain * std::sin(phase));
+                }
+
+                meter.process(channels, 2, count);
+                position += count;
+
+                if (observe)
+                    observe(static_cast<double>(position) / sampleRate);
+            }
+        }
+
+        // The integrated and range scans are spread over the following
+        // process() calls; empty calls let them finish
+        for (int i = 0; i < 1000; ++i)
+            meter.process(channels, 2, 0);
+    }
+
+    std::unique_ptr<LoudnessMeter> createMeter(double sampleRate)
+    {
+        auto meter = std::make_unique<LoudnessMeter>();
+        meter->prepare(sampleRate);
+        return meter;
+    }
+
+    std::string describe(const char* name, double sampleRate, int blockSize)
+    {
+        return std::string(name) + " @ " + std::to_string(static_cast<int>(sampleRate)) + " Hz / "
+             + std::to_string(blockSize);
+    }
+
+    //==============================================================================
+    // Tech 3341 cases 1-5: momentary, short-term and integrated, +-0.1 LU
+    void testTech3341Loudness(double sampleRate, int blockSize)
+    {
+        struct Case
+        {
+            const char* name;
+            Signal signal;
+            double expected;
+            bool checkMomentaryAndShortTerm;
+        };
+
+        const Case cases[] = {
+            { "3341 case 1", { { { 20.0, -23.0 } } }, -23.0, true },
+            { "3341 case 2", { { { 20.0, -33.0 } } }, -33.0, true },
+            { "3341 case 3", { { { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 } } }, -23.0, false },
+            { "3341 case 4", { { { 10.0, -72.0 }, { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 }, { 10.0, -72.0 } } }, -23.0, false },
+            { "3341 case 5", { { { 20.0, -26.0 }, { 20.1, -20.0 }, { 20.0, -26.0 } } }, -23.0, false },
+        };
+
+        for (const auto& c : cases)
+        {
+            const auto context = describe(c.name, sampleRate, blockSize);
+            auto meter = createMeter(sampleRate);
+            run(*meter, c.signal, sampleRate, blockSize);
+
+            expectNear(context, "integrated", meter->getIntegratedLUFS(), c.expected, 0.1);
+
+            if (c.checkMomentaryAndShortTerm)
+            {
+                expectNear(context, "momentary", meter->getMomentaryLUFS(), c.expected, 0.1);
+                expectNear(context, "short-term", meter->getShortTermLUFS(), c.expected, 0.1);
+            }
+        }
+    }
+
+    // Tech 3341 cases 9 and 12: a level that alternates within one window
+    // must read constant, -23 +-0.1 LU, once the window has filled
+    void testTech3341Windows(double sampleRate, int blockSize)
+    {
+        {
+            const auto context = describe("3341 case 9 (short-term)", sampleRate, blockSize);
+            Signal signal;
+
+            for (int i = 0; i < 5; ++i)
+            {
+                signal.segments.push_back({ 1.34, -20.0 });
+                signal.segments.push_back({ 1.66, -30.0 });
+            }
+
+            auto meter = createMeter(sampleRate);
+            double lowest = 0.0, highest = -200.0;
+
+            run(*meter, signal, sampleRate, blockSize, [&](double seconds)
+            {
+                // A block that straddles a 100 ms boundary reports the window that ended in it
+                if (seconds >= 3.0 + static_cast<double>(blockSize) / sampleRate)
+                {
+                    lowest = std::min(lowest, static_cast<double>(meter->getShortTermLUFS()));
+                    highest = std::max(highest, static_cast<double>(meter->getShortTermLUFS()));
+                }
+            });
+
+            expectNear(context, "lowest short-term", lowest, -23.0, 0.1);
+            expectNear(context, "highest short-term", highest, -23.0, 0.1);
+        }
+
+        {
+            const auto context = describe("3341 case 12 (momentary)", sampleRate, blockSize);
+            Signal signal;
+
+            for (int i = 0; i < 25; ++i)
+            {
+                signal.segments.push_back({ 0.18, -20.0 });
+                signal.segments.push_back({ 0.22, -30.0 });
+            }
+
+            auto meter = createMeter(sampleRate);
+            double lowest = 0.0, highest = -200.0;
+
+            run(*meter, signal, sampleRate, blockSize, [&](double seconds)
+            {
+                if (seconds >= 0.4 + static_cast<double>(blockSize) / sampleRate)
+                {
+                    lowest = std::min(lowest, static_cast<double>(meter->getMomentaryLUFS()));
+                    highest = std::max(highest, static_cast<double>(meter->getMomentaryLUFS()));
+                }
+            });
+
+            expectNear(context, "lowest momentary", lowest, -23.0, 0.1);
+            expectNear(context, "highest momentary", highest, -23.0, 0.1);
+        }
+    }
+
+    // Tech 3341 cases 15-19: sines whose samples miss the crests. The
+    // 48 kHz signals sit at fs/4, fs/6 and fs/8; the same frequencies are
+    // used at the other rates. The reading is the maximum over the whole
+    // run. A sine switched on at a non-zero sample is a step, and the
+    // band-limited signal through that step really does overshoot the
+    // sine's crest (by up to 1 dB, under any correct interpolator), so the
+    // signals fade in over 10 ms. Tolerance +0.2 / -0.4 dB.
+    void testTech3341TruePeak(double sampleRate, int blockSize)
+    {
+        struct Case
+        {
+            const char* name;
+            double frequency, phaseDegrees, peakdBFS;
+        };
+
+        const Case cases[] = {
+            { "3341 case 15", 12000.0, 0.0, -6.0 },
+            { "3341 case 16", 12000.0, 45.0, -6.0 },
+            { "3341 case 17", 8000.0, 60.0, -6.0 },
+            { "3341 case 18", 6000.0, 67.5, -6.0 },
+            { "3341 case 19", 12000.0, 45.0, 0.0 },
+        };
+
+        for (const auto& c : cases)
+        {
+            const auto context = describe(c.name, sampleRate, blockSize);
+
+            Signal signal;
+            signal.frequency = c.frequency;
+            signal.phaseDegrees = c.phaseDegrees;
+            signal.fadeInSeconds = 0.01;
+            signal.segments.push_back({ 4.0, c.peakdBFS });
+
+            auto meter = createMeter(sampleRate);
+            run(*meter, signal, sampleRate, blockSize);
+
+            expectNear(context, "true peak", meter->getTruePeakDecibels(), c.peakdBFS, 0.4, 0.2);
+        }
+    }
+
+    //==============================================================================
+    // Tech 3342 cases 1-4: loudness range, +-1 LU
+    void testTech3342(double sampleRate, int blockSize)
+    {
+        struct Case
+        {
+            const char* name;
+            Signal signal;
+            double expected;
+        };
+
+        const Case cases[] = {
+            { "3342 case 1", { { { 20.0, -20.0 }, { 20.0, -30.0 } } }, 10.0 },
+            { "3342 case 2", { { { 20.0, -20.0 }, { 20.0, -15.0 } } }, 5.0 },
+            { "3342 case 3", { { { 20.0, -40.0 }, { 20.0, -20.0 } } }, 20.0 },
+            { "3342 case 4", { { { 20.0, -50.0 }, { 20.0, -35.0 }, { 20.0, -20.0 }, { 20.0, -35.0 }, { 20.0, -50.0 } } }, 15.0 },
+        };
+
+        for (const auto& c : cases)
+        {
+            const auto context = describe(c.name, sampleRate, blockSize);
+            auto meter = createMeter(sampleRate);
+            run(*meter, c.signal, sampleRate, blockSize);
+
+            expectNear(context, "loudness range", meter->getLoudnessRange(), c.expected, 1.0);
+        }
+    }
+
+    //==============================================================================
+    // BS.2217 gating checks: audio under the -70 LUFS absolute gate, and
+    // audio more than 10 LU under the ungated level, must not pull the
+    // integrated value down. +-0.1 LU.
+    void testBS2217Gates(double sampleRate, int blockSize)
+    {
+        {
+            const auto context = describe("BS.2217 absolute gate", sampleRate, blockSize);
+            auto meter = createMeter(sampleRate);
+            run(*meter, { { { 20.0, -23.0 }, { 20.0, -80.0 } } }, sampleRate, blockSize);
+
+            expectNear(context, "integrated", meter->getIntegratedLUFS(), -23.0, 0.1);
+        }
+
+        {
+            const auto context = describe("BS.2217 relative gate", sampleRate, blockSize);
+            auto meter = createMeter(sampleRate);
+            run(*meter, { { { 20.0, -20.0 }, { 20.0, -35.0 } } }, sampleRate, blockSize);
+
+            expectNear(context, "integrated", meter->getIntegratedLUFS(), -20.0, 0.1);
+        }
+
+        {
+            // Nothing above the absolute gate: the meter stays at its floor
+            const auto context = describe("BS.2217 silence", sampleRate, blockSize);
+            auto meter = createMeter(sampleRate);
+            run(*meter, { { { 5.0, -80.0 } } }, sampleRate, blockSize);
+
+            expectNear(context, "integrated", meter->getIntegratedLUFS(), LoudnessMeter::silenceLUFS, 0.0);
+        }
+    }
+
+    //==============================================================================
+    // Blocks cut short by a seek: a few loud samples played just before each
+    // jump must count for their length, not as whole 100 ms blocks
+    void testShortBlocks(double sampleRate, int blockSize)
+    {
+        const auto context = describe("short blocks", sampleRate, blockSize);
+        const auto samplesPerBlock = static_cast<juce::int64>(std::llround(sampleRate * 0.1));
+        constexpr int numShortSamples = 10;
+
+        std::vector<float> samples(static_cast<size_t>(blockSize));
+        const float* channels[] = { samples.data(), samples.data() };
+
+        auto meter = createMeter(sampleRate);
+
+        auto play = [&](juce::int64 position, juce::int64 numSamples, double peakdBFS)
+        {
+            const double amplitude = std::pow(10.0, peakdBFS / 20.0);
+            meter->setTimelinePosition(position);
+
+            for (juce::int64 done = 0; done < numSamples;)
+            {
+                const int count = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), numSamples - done));
+
+                for (int i = 0; i < count; ++i)
+                    samples[static_cast<size_t>(i)] = static_cast<float>(amplitude * std::sin(juce::MathConstants<double>::twoPi
+                                                                      * 1000.0 * static_cast<double>(position + done + i) / sampleRate));
+
+                meter->process(channels, 2, count);
+                meter->setTimelinePosition(position + done + count);
+                done += count;
+            }
+        };
+
+        // 1 s at -23 dBFS, then a jump to the last few samples of a block
+        // elsewhere, played 13 dB louder, then a jump back to the grid
+        for (int i = 0; i < 60; ++i)
+        {
+            const juce::int64 start = i * 20 * samplesPerBlock;
+            play(start, 10 * samplesPerBlock, -23.0);
+            play(start + 11 * samplesPerBlock - numShortSamples, numShortSamples, -10.0);
+        }
+
+        for (int i = 0; i < 1000; ++i)
+            meter->process(channels, 2, 0);
+
+        expectNear(context, "integrated", meter->getIntegratedLUFS(), -23.0, 0.1);
+    }
+}
+
+//==============================================================================
+int main()
+{
+    for (const double sampleRate : sampleRates)
+    {
+        for (const int blockSize : blockSizes)
+        {
+            testTech3341Loudness(sampleRate, blockSize);
+            testTech3341Windows(sampleRate, blockSize);
+            testTech3341TruePeak(sampleRate, blockSize);
+            testTech3342(sampleRate, blockSize);
+            testBS2217Gates(sampleRate, blockSize);
+            testShortBlocks(sampleRate, blockSize);
+        }
+    }
+
+    std::printf("%d of %d checks passed\n", numChecks - numFailures, numChecks);
+    return numFailures == 0 ? 0 : 1;
+}
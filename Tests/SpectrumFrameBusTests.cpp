@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+    SpectrumFrameBus: frames going round the pool, what happens when
+    consumers hold every frame, the reserved-frame limit, one frame per hop
+    whatever the number of consumers, and the packed track transform.
+
+    cmake -S Tests -B build && cmake --build build && ctest --test-dir build
+  ==============================================================================
+*/
+
+#include "SpectrumFrameBus.h"
+
+#include <cstdio>
+#include <numeric>
+#include <string>
+
+namespace
+{
+    int numChecks = 0, numFailures = 0;
+
+    void expect(bool passed, const std::string& what)
+    {
+        ++numChecks;
+
+        if (passed)
+            return;
+
+        ++numFailures;
+        std::printf("FAIL %s\n", what.c_str());
+    }
+
+    void expectEqual(long long value, long long expected, const std::string& what)
+    {
+        expect(value == expected, what + " = " + std::to_string(value) + ", expected " + std::to_string(expected));
+    }
+
+    // Records what it is handed; holds on to frames when asked, as a view
+    // drawing on the message thread would
+    struct RecordingConsumer : SpectrumFrameBus::Consumer
+    {
+        void spectrumFrameReady(const SpectrumFrame& frame) override
+        {
+            seen.push_back(&frame);
+            indices.push_back(frame.index);
+
+            if (holdFrames)
+                held.push_back(frame.retain());
+        }
+
+        bool holdFrames = false;
+        std::vector<const SpectrumFrame*> seen;
+        std::vector<juce::int64> indices;
+        std::vector<SpectrumFrame::Ptr> held;
+    };
+
+    // What the analysis does for each hop
+    bool publishHop(SpectrumFrameBus& bus, int fftSize)
+    {
+        auto frame = bus.acquire(fftSize);
+
+        if (! frame)
+            return false;
+
+        bus.publish(*frame);
+        return true;
+    }
+
+    //==============================================================================
+    // Released frames go back to the pool: with nobody holding on, the same
+    // frame serves every hop and none is ever dropped
+    void testRecycling()
+    {
+        SpectrumFrameBus bus;
+        RecordingConsumer consumer;
+        bus.addConsumer(&consumer);
+
+        constexpr int numHops = 1000;
+
+        for (int hop = 0; hop < numHops; ++hop)
+            publishHop(bus, 1024);
+
+        expectEqual(static_cast<long long>(consumer.seen.size()), numHops, "recycling: frames seen");
+        expectEqual(bus.getNumDropped(), 0, "recycling: dropped");
+        expect(std::all_of(consumer.seen.begin(), consumer.seen.end(), [&](auto* f) { return f == consumer.seen[0]; }),
+               "recycling: every hop reuses the released frame");
+
+        std::vector<juce::int64> hopIndices(numHops);
+        std::iota(hopIndices.begin(), hopIndices.end(), juce::int64 { 0 });
+        expect(consumer.indices == hopIndices, "recycling: frames are indexed in hop order");
+
+        const auto& frame = *consumer.seen[0];
+        expectEqual(frame.fftSize, 1024, "recycling: fftSize");
+        expectEqual(frame.numBins, 513, "recycling: numBins");
+        expectEqual(static_cast<long long>(frame.trackSpectrum.size()), 1024, "recycling: trackSpectrum size");
+
+        for (const auto& power : frame.power)
+            expectEqual(static_cast<long long>(power.size()), 513, "recycling: power size");
+
+        // A copy shares the reference; only the last one out frees the frame
+        auto first = bus.acquire(512);
+        auto copy = first;
+        first = {};
+        auto second = bus.acquire(512);
+        expect(second.get() != copy.get(), "recycling: a copied Ptr keeps the frame");
+
+        copy = {};
+        second = {};
+        expect(bus.acquire(512).get() == consumer.seen[0], "recycling: frame free once the copies are gone");
+
+        bus.removeConsumer(&consumer);
+    }
+
+    //==============================================================================
+    // Consumers holding every frame: hops are dropped and counted, without
+    // blocking, until a frame is released
+    void testExhaustion()
+    {
+        SpectrumFrameBus bus;
+        RecordingConsumer consumer;
+        consumer.holdFrames = true;
+        bus.addConsumer(&consumer);
+
+        for (int hop = 0; hop < SpectrumFrameBus::poolSize; ++hop)
+            expect(publishHop(bus, 256), "exhaustion: hop " + std::to_string(hop) + " while frames are free");
+
+        expect(! publishHop(bus, 256), "exhaustion: acquire fails with every frame held");
+        expect(! publishHop(bus, 256), "exhaustion: and keeps failing");
+        expectEqual(bus.getNumDropped(), 2, "exhaustion: dropped");
+        expectEqual(static_cast<long long>(consumer.seen.size()), SpectrumFrameBus::poolSize, "exhaustion: frames seen");
+
+        // Releasing one retained frame makes exactly that one available
+        const auto* released = consumer.held[5].get();
+        consumer.held[5] = {};
+        consumer.holdFrames = false;
+
+        expect(publishHop(bus, 256), "exhaustion: acquire succeeds after a release");
+        expect(consumer.seen.back() == released, "exhaustion: the released frame is reused");
+        expectEqual(consumer.indices.back(), SpectrumFrameBus::poolSize, "exhaustion: dropped hops take no index");
+
+        consumer.held.clear();
+        expect(publishHop(bus, 256), "exhaustion: acquire succeeds once everything is released");
+        expectEqual(bus.getNumDropped(), 2, "exhaustion: dropped after recovery");
+
+        bus.removeConsumer(&consumer);
+    }
+
+    //==============================================================================
+    // After reserve(), only the reserved frames are handed out, and they are
+    // already large enough for every FFT size up to the maximum
+    void testReserve()
+    {
+        SpectrumFrameBus bus;
+        bus.reserve(4096, 4);
+
+        std::vector<SpectrumFrame::Ptr> held;
+
+        for (int i = 0; i < 4; ++i)
+            held.push_back(bus.acquire(4096));
+
+        expect(std::all_of(held.begin(), held.end(), [](auto& f) { return static_cast<bool>(f); }),
+               "reserve: the reserved frames can be acquired");
+        expect(! bus.acquire(4096), "reserve: no frame past the reserved ones");
+        expectEqual(bus.getNumDropped(), 1, "reserve: dropped");
+
+        // Changing the FFT size within the reservation must not reallocate
+        const auto* spectrum = held[0]->trackSpectrum.data();
+        const auto* power = held[0]->power[2].data();
+        auto* frame = held[0].get();
+        held.clear();
+
+        for (int order = 12; order >= 6; --order)
+        {
+            auto reacquired = bus.acquire(1 << order);
+            expect(reacquired.get() == frame, "reserve: first reserved frame reacquired");
+            expect(reacquired->trackSpectrum.data() == spectrum && reacquired->power[2].data() == power,
+                   "reserve: no reallocation at FFT size " + std::to_string(1 << order));
+        }
+    }
+
+    //==============================================================================
+    // However many consumers there are, each hop is one frame, so one
+    // transform, and every consumer reads that same frame in hop order
+    void testConsumers()
+    {
+        constexpr int numHops = 50;
+
+        for (const int numConsumers : { 1, 2, SpectrumFrameBus::maxConsumers })
+        {
+            const std::string context = "consumers (" + std::to_string(numConsumers) + ")";
+            SpectrumFrameBus bus;
+            std::vector<RecordingConsumer> consumers(static_cast<size_t>(numConsumers));
+            int numAcquired = 0;
+
+            for (auto& consumer : consumers)
+                expect(bus.addConsumer(&consumer), context + ": consumer added");
+
+            for (int hop = 0; hop < numHops; ++hop)
+                numAcquired += publishHop(bus, 2048) ? 1 : 0;
+
+            expectEqual(numAcquired, numHops, context + ": frames acquired");
+
+            for (const auto& consumer : consumers)
+            {
+                expect(consumer.seen == consumers[0].seen, context + ": same frames as the first consumer");
+                expect(consumer.indices == consumers[0].indices, context + ": same hop order as the first consumer");
+            }
+
+            // A removed consumer isn't called again; the others carry on
+            bus.removeConsumer(&consumers.back());
+            publishHop(bus, 2048);
+
+            expectEqual(static_cast<long long>(consumers.back().seen.size()), numHops, context + ": calls after removal");
+            expectEqual(static_cast<long long>(consumers[0].seen.size()), numHops + (numConsumers > 1 ? 1 : 0),
+                        context + ": calls to the others after a removal");
+
+            for (auto& consumer : consumers)
+                bus.removeConsumer(&consumer);
+        }
+    }
+
+    //==============================================================================
+    // The track pair is packed as Z = A + jB; getTrackBin must give back the
+    // transforms of A and B on their own
+    void testTrackBins()
+    {
+        constexpr int size = 64;
+        SpectrumFrameBus bus;
+        auto frame = bus.acquire(size);
+
+        std::vector<float> a(size), b(size);
+
+        for (int n = 0; n < size; ++n)
+        {
+            a[static_cast<size_t>(n)] = std::sin(0.37f * static_cast<float>(n)) + 0.25f;
+            b[static_cast<size_t>(n)] = std::cos(1.9f * static_cast<float>(n)) * 0.5f - 0.1f * static_cast<float>(n % 5);
+        }
+
+        auto transform = [&](const std::vector<float>& re, const std::vector<float>& im, int k)
+        {
+            std::complex<double> sum;
+
+            for (int n = 0; n < size; ++n)
+            {
+                const double angle = -juce::MathConstants<double>::twoPi * k * n / size;
+                sum += std::complex<double>(re[static_cast<size_t>(n)], im[static_cast<size_t>(n)]) * std::polar(1.0, angle);
+            }
+
+            return sum;
+        };
+
+        const std::vector<float> zero(size, 0.0f);
+
+        for (int k = 0; k < size; ++k)
+            frame->trackSpectrum[static_cast<size_t>(k)] = std::complex<float>(transform(a, b, k));
+
+        double error = 0.0;
+
+        for (int k = 0; k < frame->numBins; ++k)
+        {
+            error = std::max(error, std::abs(std::complex<double>(frame->getTrackBin(0, k)) - transform(a, zero, k)));
+            error = std::max(error, std::abs(std::complex<double>(frame->getTrackBin(1, k)) - transform(b, zero, k)));
+        }
+
+        expect(error < 1.0e-4, "track bins: largest error " + std::to_string(error));
+    }
+}
+
+//==============================================================================
+int main()
+{
+    testRecycling();
+    testExhaustion();
+    testReserve();
+    testConsumers();
+    testTrackBins();
+
+    std::printf("%d of %d checks passed\n", numChecks - numFailures, numChecks);
+    return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+    Test client for the meter feed: prints every live TrackTweak instance.
+
+    c++ -std=c++17 -O2 -I../../Source MeterFeedReader.cpp MeterFeedClient.cpp -o meterfeed-client
+    (add -lrt on glibc older than 2.34)
+
+    Usage: meterfeed-client [--once]
+  ==============================================================================
+*/
+
+#include "MeterFeedReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    // A coarse text bar of the compact spectrum, -80..0 dB
+    void printSpectrum(const float* spectrum)
+    {
+        static const char levels[] = " .:-=+*#%@";
+
+        for (int band = 0; band < MeterFeedLayout::numSpectrumBands; ++band)
+        {
+            const float position = (spectrum[band] + 80.0f) / 80.0f;
+            const int index = position <= 0.0f ? 0 : position >= 1.0f ? 9 : static_cast<int>(position * 9.0f);
+            std::putchar(levels[index]);
+        }
+
+        std::putchar('\n');
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const bool once = argc > 1 && std::strcmp(argv[1], "--once") == 0;
+    MeterFeedReader reader;
+
+    for (;;)
+    {
+        if (! reader.isOpen() && ! reader.open())
+        {
+            std::printf("Waiting for a TrackTweak instance...\n");
+        }
+        else
+        {
+            const auto instances = reader.readAll();
+
+            std::printf("\n%-4s %-8s %-24s %8s %8s %8s %8s %10s\n",
+                        "Slot", "PID", "Name", "M LUFS", "S LUFS", "I LUFS", "Peak", "Frame");
+
+            for (const auto& instance : instances)
+            {
+                const auto& v = instance.values;
+
+                std::printf("%-4d %-8u %-24.24s %8.1f %8.1f %8.1f %8.3f %10llu\n",
+                            instance.slot, instance.pid, v.name, v.momentaryLUFS, v.shortTermLUFS,
+                            v.integratedLUFS, v.peak, static_cast<unsigned long long>(v.frameCounter));
+                std::printf("     ");
+                printSpectrum(v.spectrum);
+            }
+
+            if (instances.empty())
+                std::printf("(no live instances)\n");
+        }
+
+        if (once)
+            break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+    Reader for the TrackTweak shared-memory meter feed (POSIX, no JUCE).
+  ==============================================================================
+*/
+
+#include "MeterFeedReader.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//==============================================================================
+MeterFeedReader::~MeterFeedReader()
+{
+    close();
+}
+
+bool MeterFeedReader::open()
+{
+    using namespace MeterFeedLayout;
+
+    if (segment != nullptr)
+        return true;
+
+    const int fd = shm_open(segmentName, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Segment)))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapped == MAP_FAILED)
+        return false;
+
+    segment = static_cast<const Segment*>(mapped);
+    const auto& header = segment->header;
+
+    if (header.magic.load(std::memory_order_acquire) != magic
+        || header.version != version || header.slotSize != sizeof(Slot))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MeterFeedReader::close()
+{
+    if (segment != nullptr)
+        munmap(const_cast<MeterFeedLayout::Segment*>(segment), sizeof(MeterFeedLayout::Segment));
+
+    segment = nullptr;
+}
+
+//==============================================================================
+std::vector<MeterFeedReader::Instance> MeterFeedReader::readAll() const
+{
+    std::vector<Instance> instances;
+
+    if (segment == nullptr)
+        return instances;
+
+    for (int i = 0; i < MeterFeedLayout::numSlots; ++i)
+    {
+        const auto& slot = segment->slots[i];
+        const auto pid = slot.ownerPid.load(std::memory_order_acquire);
+
+        // Free, or left behind by a host that crashed
+        if (pid == 0 || (kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH))
+            continue;
+
+        Instance instance{ i, pid, {} };
+        if (MeterFeedLayout::readSlot(slot, instance.values))
+            instances.push_back(instance);
+    }
+
+    return instances;
+}
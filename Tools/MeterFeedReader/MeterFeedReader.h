@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+    Reader for the TrackTweak shared-memory meter feed (POSIX, no JUCE).
+  ==============================================================================
+*/
+
+#pragma once
+#include "MeterFeedLayout.h"
+#include <vector>
+
+//==============================================================================
+// Maps the feed segment read-only and copies out consistent snapshots of
+// every live instance. Reading never blocks or disturbs the writers.
+class MeterFeedReader
+{
+public:
+    struct Instance
+    {
+        int slot;
+        std::uint32_t pid;
+        MeterFeedLayout::Payload values;
+    };
+
+    MeterFeedReader() = default;
+    ~MeterFeedReader();
+
+    MeterFeedReader(const MeterFeedReader&) = delete;
+    MeterFeedReader& operator=(const MeterFeedReader&) = delete;
+
+    // False until at least one plugin instance has created the segment
+    bool open();
+    void close();
+    bool isOpen() const { return segment != nullptr; }
+
+    // Instances whose owning process is still alive; a slot that stays busy
+    // for every retry is skipped until the next call
+    std::vector<Instance> readAll() const;
+
+private:
+    const MeterFeedLayout::Segment* segment = nullptr;
+};